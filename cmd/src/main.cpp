@@ -1,22 +1,83 @@
 #include <src/tint/utils/cli/cli.h>
 #include <src/tint/utils/containers/transform.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "minifier/minifier.h"
 #include "writer/writer.h"
 
 struct Options {
     std::string input;
+    bool source_map = false;
+    bool split_entry_points = false;
+    bool inline_functions = false;
+    std::vector<std::string> disabled_passes;
+    std::vector<std::string> entry_points;
+    std::unordered_map<std::string, double> overrides;
 };
 
+// The passes --disable can turn off, by the name of their option
+static constexpr std::pair<std::string_view, bool wgslx::minifier::Options::*> Passes[] = {
+    {"rename-identifiers", &wgslx::minifier::Options::rename_identifiers},
+    {"remove-unreachable-statements", &wgslx::minifier::Options::remove_unreachable_statements},
+    {"remove-useless", &wgslx::minifier::Options::remove_useless},
+    {"fold-constants", &wgslx::minifier::Options::fold_constants},
+    {"promote-variables", &wgslx::minifier::Options::promote_variables},
+    {"fold-branches", &wgslx::minifier::Options::fold_branches},
+    {"simplify-algebra", &wgslx::minifier::Options::simplify_algebra},
+    {"shorten-constructors", &wgslx::minifier::Options::shorten_constructors},
+    {"inline-constants", &wgslx::minifier::Options::inline_constants},
+    {"canonicalize-swizzles", &wgslx::minifier::Options::canonicalize_swizzles},
+    {"remove-identity-conversions", &wgslx::minifier::Options::remove_identity_conversions},
+    {"inline-lets", &wgslx::minifier::Options::inline_lets},
+    {"hoist-common-subexpressions", &wgslx::minifier::Options::hoist_common_subexpressions},
+    {"remove-pure-calls", &wgslx::minifier::Options::remove_pure_calls},
+    {"prune-struct-members", &wgslx::minifier::Options::prune_struct_members},
+    {"shorten-assignments", &wgslx::minifier::Options::shorten_assignments},
+    {"elide-declaration-types", &wgslx::minifier::Options::elide_declaration_types},
+};
+
+// Splits a comma separated list, skipping empty items
+static std::vector<std::string_view> SplitList(std::string_view list) {
+    std::vector<std::string_view> items;
+    while (!list.empty()) {
+        auto comma = std::min(list.find(','), list.size());
+        if (comma != 0) {
+            items.push_back(list.substr(0, comma));
+        }
+        list.remove_prefix(std::min(comma + 1, list.size()));
+    }
+    return items;
+}
+
 static bool ParseArgs(tint::VectorRef<std::string_view> arguments, Options* opts) {
     tint::cli::OptionSet options;
 
     auto& help = options.Add<tint::cli::BoolOption>("help", "Show usage", tint::cli::ShortName {"h"});
+    auto& source_map = options.Add<tint::cli::BoolOption>("source-map", "Emit a source map of the output");
+    auto& split_entry_points =
+        options.Add<tint::cli::BoolOption>("split-entry-points", "Emit a separate module for each entry point");
+    auto& inline_functions =
+        options.Add<tint::cli::BoolOption>("inline-functions", "Inline functions where that is shorter");
+    auto& disable = options.Add<tint::cli::StringOption>(
+        "disable", "Comma separated passes to skip, such as inline-lets", tint::cli::Parameter {"passes"}
+    );
+    auto& entry_points = options.Add<tint::cli::StringOption>(
+        "entry-points", "Comma separated entry points to keep, the others are removed", tint::cli::Parameter {"names"}
+    );
+    auto& overrides = options.Add<tint::cli::StringOption>(
+        "overrides", "Comma separated override values, keyed by name or id", tint::cli::Parameter {"name=value"}
+    );
 
     auto show_usage = [&] {
         std::cout << R"(Usage: wgslx <input-file>
@@ -36,6 +97,43 @@ Options:
         show_usage();
         return false;
     }
+    opts->source_map = source_map.value.value_or(false);
+    opts->split_entry_points = split_entry_points.value.value_or(false);
+    opts->inline_functions = inline_functions.value.value_or(false);
+    if (disable.value) {
+        for (auto name : SplitList(*disable.value)) {
+            auto known = std::any_of(std::begin(Passes), std::end(Passes), [&](const auto& pass) {
+                return pass.first == name;
+            });
+            if (!known) {
+                std::cerr << "Unknown pass: " << name << "\n";
+                return false;
+            }
+            opts->disabled_passes.emplace_back(name);
+        }
+    }
+    if (entry_points.value) {
+        for (auto name : SplitList(*entry_points.value)) {
+            opts->entry_points.emplace_back(name);
+        }
+    }
+    if (overrides.value) {
+        for (auto item : SplitList(*overrides.value)) {
+            auto equal = item.find('=');
+            std::string value(equal == std::string_view::npos ? std::string_view {} : item.substr(equal + 1));
+            // Bool overrides take true and false, stored as 1 and 0 like the numeric values
+            if (value == "true" || value == "false") {
+                value = value == "true" ? "1" : "0";
+            }
+            char* end = nullptr;
+            auto number = std::strtod(value.c_str(), &end);
+            if (equal == 0 || value.empty() || *end != '\0') {
+                std::cerr << "Invalid override value: " << item << "\n";
+                return false;
+            }
+            opts->overrides[std::string(item.substr(0, equal))] = number;
+        }
+    }
 
     auto files = result.Get();
     if (files.IsEmpty()) {
@@ -54,6 +152,21 @@ Options:
     return true;
 }
 
+static bool Output(const wgslx::minifier::Result& minifier_res, const Options& options, nlohmann::json& j) {
+    auto writer_res = wgslx::writer::Write(minifier_res.program, {.source_map = options.source_map});
+    if (writer_res.failed) {
+        std::cerr << writer_res.failure_message << "\n";
+        return false;
+    }
+
+    j["wgsl"] = writer_res.wgsl;
+    j["remappings"] = minifier_res.remappings;
+    if (options.source_map) {
+        j["source_map"] = writer_res.source_map;
+    }
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     tint::Vector<std::string_view, 8> arguments;
     for (int i = 1; i < argc; i++) {
@@ -73,21 +186,42 @@ int main(int argc, char* argv[]) {
     stream << file.rdbuf();
     auto content = std::move(stream).str();
 
-    auto minifier_res = wgslx::minifier::Minify(content, {});
-    if (minifier_res.failed) {
-        std::cerr << minifier_res.failure_message << "\n";
-        return 1;
-    }
-
-    auto writer_res = wgslx::writer::Write(minifier_res.program, {});
-    if (writer_res.failed) {
-        std::cerr << writer_res.failure_message << "\n";
-        return 1;
+    wgslx::minifier::Options minifier_options {
+        .inline_functions = options.inline_functions,
+        .entry_points = options.entry_points,
+        .overrides = options.overrides,
+    };
+    for (const auto& name : options.disabled_passes) {
+        for (const auto& [pass, flag] : Passes) {
+            if (pass == name) {
+                minifier_options.*flag = false;
+            }
+        }
     }
 
     nlohmann::json j;
-    j["wgsl"] = writer_res.wgsl;
-    j["remappings"] = minifier_res.remappings;
+    if (options.split_entry_points) {
+        auto split_res = wgslx::minifier::MinifyEntryPoints(content, minifier_options);
+        if (split_res.failed) {
+            std::cerr << split_res.failure_message << "\n";
+            return 1;
+        }
+        j["entry_points"] = nlohmann::json::object();
+        for (const auto& entry_point : split_res.entry_points) {
+            if (!Output(entry_point.result, options, j["entry_points"][entry_point.entry_point])) {
+                return 1;
+            }
+        }
+    } else {
+        auto minifier_res = wgslx::minifier::Minify(content, minifier_options);
+        if (minifier_res.failed) {
+            std::cerr << minifier_res.failure_message << "\n";
+            return 1;
+        }
+        if (!Output(minifier_res, options, j)) {
+            return 1;
+        }
+    }
     std::cout << j.dump() << "\n";
 
     return 0;
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <src/tint/lang/wgsl/program/program.h>
+#include <src/tint/utils/diagnostic/source.h>
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace wgslx::minifier {
 
@@ -13,15 +16,54 @@ struct Options {
     bool remove_unreachable_statements = true;
     bool remove_useless = true;
     bool fold_constants = true;
+    // Each of these runs the pass of the same name, so a single one can be turned off
+    bool promote_variables = true;
+    bool fold_branches = true;
+    bool simplify_algebra = true;
+    bool shorten_constructors = true;
+    bool inline_constants = true;
+    // Inlines functions at their call sites where that is shorter. Off by default since it restructures the code.
+    bool inline_functions = false;
+    bool canonicalize_swizzles = true;
+    bool remove_identity_conversions = true;
+    bool inline_lets = true;
+    bool hoist_common_subexpressions = true;
+    bool remove_pure_calls = true;
+    bool prune_struct_members = true;
+    bool shorten_assignments = true;
+    bool elide_declaration_types = true;
+    // The entry points to keep, all of them if empty. The others are removed with everything only they use.
+    std::vector<std::string> entry_points;
+    // Known values of overrides, keyed by name or by @id. Those overrides become consts.
+    std::unordered_map<std::string, double> overrides;
 };
 
 struct Result {
     tint::Program program;
     std::unordered_map<std::string, std::string> remappings;
+    // The parsed input, which the sources of the program refer to.
+    std::unique_ptr<tint::Source::File> file;
+    std::string failure_message;
+    bool failed = false;
+};
+
+struct EntryPointResult {
+    std::string entry_point;
+    // Only contains the declarations reachable from the entry point. The remappings are those of this module.
+    Result result;
+};
+
+struct SplitResult {
+    std::vector<EntryPointResult> entry_points;
+    // The parsed input, which the sources of all programs refer to.
+    std::unique_ptr<tint::Source::File> file;
     std::string failure_message;
     bool failed = false;
 };
 
 Result Minify(std::string_view data, const Options& options);
 
+// Minifies each entry point of `data` into its own module.
+SplitResult MinifyEntryPoints(std::string_view data, const Options& options);
+
 }  // namespace wgslx::minifier
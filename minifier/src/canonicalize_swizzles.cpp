@@ -0,0 +1,183 @@
+#include "canonicalize_swizzles.h"
+
+#include <src/tint/lang/core/type/vector.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/sem/value_constructor.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "expressions.h"
+#include "purity.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::CanonicalizeSwizzles);
+
+namespace wgslx::minifier {
+
+static constexpr const char* Xyzw = "xyzw";
+static constexpr const char* Rgba = "rgba";
+
+static const tint::sem::Swizzle* GetSwizzle(const tint::Program& program, const tint::ast::Expression* expr) {
+    const auto* sem = expr->Is<tint::ast::MemberAccessorExpression>() ? GetValue(program, expr) : nullptr;
+    return sem ? sem->Unwrap()->As<tint::sem::Swizzle>() : nullptr;
+}
+
+// The vector swizzled, or nullptr if it is a pointer, which swizzles dereference
+static const tint::core::type::Vector* GetVector(const tint::sem::Swizzle* swizzle) {
+    return swizzle->Object()->Type()->UnwrapRef()->As<tint::core::type::Vector>();
+}
+
+static std::string ToMember(const std::vector<std::uint32_t>& indices, const char* alphabet) {
+    std::string member;
+    for (auto index : indices) {
+        member += alphabet[index];
+    }
+    return member;
+}
+
+static bool IsIdentity(const std::vector<std::uint32_t>& indices, const tint::core::type::Vector* vector) {
+    if (!vector || indices.size() != vector->Width()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class Canonicalizer {
+ public:
+    explicit Canonicalizer(tint::program::CloneContext* ctx) : ctx_(ctx), program_(*ctx->src), purity_(program_) {}
+
+    bool Run() {
+        // Letters written in either alphabet, the alphabets are never mixed in a swizzle
+        std::size_t xyzw = 0;
+        std::size_t rgba = 0;
+        for (const auto* node : program_.AST().GlobalDeclarations()) {
+            TraverseNodes<tint::ast::MemberAccessorExpression>(
+                node,
+                [&](const tint::ast::MemberAccessorExpression* accessor) {
+                    if (GetSwizzle(program_, accessor)) {
+                        const auto& name = accessor->member->symbol.Name();
+                        (name.find_first_of(Rgba) == std::string::npos ? xyzw : rgba) += name.size();
+                    }
+                }
+            );
+        }
+        alphabet_ = rgba > xyzw ? Rgba : Xyzw;
+
+        auto changed = false;
+        for (const auto* node : program_.AST().GlobalDeclarations()) {
+            TraverseNodes<tint::ast::Expression>(node, [&](const tint::ast::Expression* expr) {
+                if (const auto* accessor = expr->As<tint::ast::MemberAccessorExpression>()) {
+                    changed = Swizzle(accessor) || changed;
+                } else if (const auto* call = expr->As<tint::ast::CallExpression>()) {
+                    changed = Construct(call) || changed;
+                }
+            });
+        }
+        return changed;
+    }
+
+ private:
+    tint::program::CloneContext* ctx_;
+    const tint::Program& program_;
+    Purity purity_;
+    const char* alphabet_ = Xyzw;
+
+    bool Swizzle(const tint::ast::MemberAccessorExpression* accessor) {
+        const auto* swizzle = GetSwizzle(program_, accessor);
+        if (!swizzle) {
+            return false;
+        }
+        std::vector<std::uint32_t> indices(swizzle->Indices().begin(), swizzle->Indices().end());
+        if (IsIdentity(indices, GetVector(swizzle))) {
+            ctx_->Replace(accessor, [ctx = ctx_, accessor] { return ctx->Clone(accessor->object); });
+            return true;
+        }
+        auto member = ToMember(indices, alphabet_);
+        if (member == accessor->member->symbol.Name()) {
+            return false;
+        }
+        ctx_->Replace(accessor, [ctx = ctx_, accessor, member] {
+            return ctx->dst->MemberAccessor(ctx->Clone(accessor->object), member);
+        });
+        return true;
+    }
+
+    // A vector constructor of swizzles of the same vector, together swizzling it to the constructed type
+    bool Construct(const tint::ast::CallExpression* call) {
+        const auto* sem = GetValue(program_, call);
+        const auto* target = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+        const auto* type = target ? target->Type()->As<tint::core::type::Vector>() : nullptr;
+        if (!type || !target->Target()->Is<tint::sem::ValueConstructor>() || call->args.Length() < 2) {
+            return false;
+        }
+
+        const tint::ast::Expression* object = nullptr;
+        const tint::core::type::Vector* vector = nullptr;
+        std::vector<std::uint32_t> indices;
+        for (const auto* arg : call->args) {
+            const auto* swizzle = GetSwizzle(program_, arg);
+            if (!swizzle) {
+                return false;
+            }
+            const auto* accessor = arg->As<tint::ast::MemberAccessorExpression>();
+            if (!object) {
+                object = accessor->object;
+                vector = GetVector(swizzle);
+                // It is evaluated once instead of once per argument
+                if (!vector || vector->Type() != type->Type() || !purity_.IsPure(object)) {
+                    return false;
+                }
+            } else if (!IsSameExpression(program_, object, accessor->object)) {
+                return false;
+            }
+            indices.insert(indices.end(), swizzle->Indices().begin(), swizzle->Indices().end());
+        }
+        if (indices.size() != type->Width()) {
+            return false;
+        }
+
+        if (IsIdentity(indices, vector)) {
+            ctx_->Replace(call, [ctx = ctx_, object] { return ctx->Clone(object); });
+        } else {
+            ctx_->Replace(call, [ctx = ctx_, object, member = ToMember(indices, alphabet_)] {
+                return ctx->dst->MemberAccessor(ctx->Clone(object), member);
+            });
+        }
+        return true;
+    }
+};
+
+CanonicalizeSwizzles::ApplyResult CanonicalizeSwizzles::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    Canonicalizer canonicalizer(&ctx);
+    if (!canonicalizer.Run()) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
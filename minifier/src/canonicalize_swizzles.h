@@ -0,0 +1,19 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Rewrites identity swizzles such as `v.xyzw` of a vec4 to the vector itself, and vector constructors of swizzles of
+// the same vector such as `vec3f(v.x, v.y, v.z)` to a single swizzle `v.xyz`. Swizzles are then written in the one of
+// the `xyzw` and `rgba` alphabets used most in the module, so that they repeat more.
+class CanonicalizeSwizzles final : public tint::Castable<CanonicalizeSwizzles, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <src/tint/lang/core/constant/value.h>
+#include <src/tint/lang/core/type/scalar.h>
+
+#include <cmath>
+
+namespace wgslx::minifier {
+
+// Whether `a` and `b` are scalars of the same value, including the sign of zero. Booleans compare as 0 and 1.
+inline bool IsSameScalar(const tint::core::constant::Value* a, const tint::core::constant::Value* b) {
+    if (!a || !b || !a->Type()->Is<tint::core::type::Scalar>() || !b->Type()->Is<tint::core::type::Scalar>()) {
+        return false;
+    }
+    auto x = a->ValueAs<double>();
+    auto y = b->ValueAs<double>();
+    return x == y && std::signbit(x) == std::signbit(y);
+}
+
+// Whether every component of `value` is `expected`, including the sign of zero. Booleans compare as 0 and 1.
+inline bool IsSplatOf(const tint::core::constant::Value* value, double expected) {
+    if (!value) {
+        return false;
+    }
+    if (value->Type()->Is<tint::core::type::Scalar>()) {
+        auto v = value->ValueAs<double>();
+        return v == expected && std::signbit(v) == std::signbit(expected);
+    }
+    auto count = value->Type()->Elements().count;
+    if (count == 0) {
+        return false;
+    }
+    for (decltype(count) i = 0; i < count; ++i) {
+        if (!IsSplatOf(value->Index(i), expected)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/identifier.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/templated_identifier.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+namespace wgslx::minifier {
+
+// Value constructors which infer their type from the arguments, as they are written without template arguments
+inline bool IsInferringConstructor(const tint::ast::CallExpression* call) {
+    static constexpr std::string_view Names[] = {
+        "vec2", "vec3", "vec4", "mat2x2", "mat2x3", "mat2x4", "mat3x2", "mat3x3",
+        "mat3x4", "mat4x2", "mat4x3", "mat4x4", "array",
+    };
+    const auto* ident = call->target->identifier;
+    return !ident->Is<tint::ast::TemplatedIdentifier>() &&
+           std::find(std::begin(Names), std::end(Names), ident->symbol.Name()) != std::end(Names);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,104 @@
+#include "declaration_graph.h"
+
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/type_decl.h>
+#include <src/tint/lang/wgsl/ast/variable.h>
+
+#include <vector>
+
+#include "traverser.h"
+
+namespace wgslx::minifier {
+
+const tint::ast::Identifier* DeclarationGraph::DeclarationName(const tint::ast::Node* node) {
+    if (const auto* function = node->As<tint::ast::Function>()) {
+        return function->name;
+    }
+    // const, override and var
+    if (const auto* variable = node->As<tint::ast::Variable>()) {
+        return variable->name;
+    }
+    // struct and alias
+    if (const auto* type = node->As<tint::ast::TypeDecl>()) {
+        return type->name;
+    }
+    return nullptr;
+}
+
+DeclarationGraph::DeclarationGraph(const tint::Program& program) {
+    const auto& globals = program.AST().GlobalDeclarations();
+    declarations_.reserve(globals.Length());
+    for (const auto* node : globals) {
+        if (const auto* name = DeclarationName(node)) {
+            ids_.Add(name->symbol, static_cast<Id>(declarations_.size()));
+            declarations_.push_back(node);
+        }
+    }
+
+    // The last declaration which referenced each target, to drop duplicated edges
+    std::vector<Id> last_source(declarations_.size(), NoId);
+    offsets_.reserve(declarations_.size() + 1);
+    for (Id id = 0; id < declarations_.size(); ++id) {
+        offsets_.push_back(static_cast<std::uint32_t>(targets_.size()));
+        TraverseIdentifiers(declarations_[id], [&](const tint::ast::Identifier* i) {
+            auto target = Find(i->symbol);
+            if (target != NoId && target != id && last_source[target] != id) {
+                last_source[target] = id;
+                targets_.push_back(target);
+            }
+        });
+    }
+    offsets_.push_back(static_cast<std::uint32_t>(targets_.size()));
+}
+
+DeclarationGraph::Id DeclarationGraph::Find(tint::Symbol symbol) const {
+    if (auto id = ids_.Get(symbol)) {
+        return *id;
+    }
+    return NoId;
+}
+
+std::vector<DeclarationGraph::Id> DeclarationGraph::EntryPoints() const {
+    std::vector<Id> entry_points;
+    for (Id id = 0; id < declarations_.size(); ++id) {
+        const auto* function = declarations_[id]->As<tint::ast::Function>();
+        if (function && function->IsEntryPoint()) {
+            entry_points.push_back(id);
+        }
+    }
+    return entry_points;
+}
+
+std::vector<DeclarationGraph::Id> DeclarationGraph::References(const tint::ast::Node* node) const {
+    std::vector<Id> refs;
+    TraverseIdentifiers(node, [&](const tint::ast::Identifier* i) {
+        auto target = Find(i->symbol);
+        if (target != NoId) {
+            refs.push_back(target);
+        }
+    });
+    return refs;
+}
+
+std::vector<bool> DeclarationGraph::Reach(const std::vector<Id>& roots) const {
+    std::vector<bool> reached(declarations_.size());
+    std::vector<Id> worklist(roots);
+    while (!worklist.empty()) {
+        auto id = worklist.back();
+        worklist.pop_back();
+        if (reached[id]) {
+            continue;
+        }
+        reached[id] = true;
+
+        for (auto i = offsets_[id]; i < offsets_[id + 1]; ++i) {
+            if (!reached[targets_[i]]) {
+                worklist.push_back(targets_[i]);
+            }
+        }
+    }
+    return reached;
+}
+
+}  // namespace wgslx::minifier
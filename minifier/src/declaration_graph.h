@@ -0,0 +1,55 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/identifier.h>
+#include <src/tint/lang/wgsl/ast/node.h>
+#include <src/tint/lang/wgsl/program/program.h>
+#include <src/tint/utils/containers/hashmap.h>
+#include <src/tint/utils/symbol/symbol.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace wgslx::minifier {
+
+// References between module scope functions, variables and types. Declarations get dense ids in declaration order
+// and their references are stored as flat adjacency arrays, so reachability only needs a bitset and a worklist.
+class DeclarationGraph {
+ public:
+    using Id = std::uint32_t;
+
+    static constexpr Id NoId = std::numeric_limits<Id>::max();
+
+    explicit DeclarationGraph(const tint::Program& program);
+
+    [[nodiscard]] std::size_t Size() const {
+        return declarations_.size();
+    }
+
+    [[nodiscard]] const tint::ast::Node* Declaration(Id id) const {
+        return declarations_[id];
+    }
+
+    // Returns NoId if `symbol` isn't a tracked declaration
+    [[nodiscard]] Id Find(tint::Symbol symbol) const;
+
+    [[nodiscard]] std::vector<Id> EntryPoints() const;
+
+    // The declarations referenced by a node which isn't part of the graph itself
+    [[nodiscard]] std::vector<Id> References(const tint::ast::Node* node) const;
+
+    // Returns a bitset of the declarations reachable from `roots`, including the roots
+    [[nodiscard]] std::vector<bool> Reach(const std::vector<Id>& roots) const;
+
+    static const tint::ast::Identifier* DeclarationName(const tint::ast::Node* node);
+
+ private:
+    std::vector<const tint::ast::Node*> declarations_;
+    // The references of `id` are targets_[offsets_[id], offsets_[id + 1])
+    std::vector<std::uint32_t> offsets_;
+    std::vector<Id> targets_;
+    tint::Hashmap<tint::Symbol, Id, 16> ids_;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,183 @@
+#include "elide_declaration_types.h"
+
+#include <src/tint/lang/core/binary_op.h>
+#include <src/tint/lang/core/type/abstract_float.h>
+#include <src/tint/lang/core/type/abstract_int.h>
+#include <src/tint/lang/core/type/array.h>
+#include <src/tint/lang/core/type/bool.h>
+#include <src/tint/lang/core/type/f16.h>
+#include <src/tint/lang/core/type/f32.h>
+#include <src/tint/lang/core/type/i32.h>
+#include <src/tint/lang/core/type/matrix.h>
+#include <src/tint/lang/core/type/u32.h>
+#include <src/tint/lang/core/type/vector.h>
+#include <src/tint/lang/core/unary_op.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/const.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/let.h>
+#include <src/tint/lang/wgsl/ast/literal_expression.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/builtin_fn.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <algorithm>
+
+#include "constructors.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::ElideDeclarationTypes);
+
+namespace wgslx::minifier {
+
+// Whether `expr` would be abstract without literal suffixes, as its type only comes from its literals
+static bool IsUntyped(const tint::Program& program, const tint::ast::Expression* expr) {
+    auto untyped = [&](const tint::ast::Expression* e) { return IsUntyped(program, e); };
+    return tint::Switch(
+        expr,
+        [&](const tint::ast::LiteralExpression*) { return true; },
+        [&](const tint::ast::IdentifierExpression*) {
+            const auto* sem = program.Sem().GetVal(expr)->UnwrapMaterialize();
+            if (sem->Type()->IsAbstract()) {
+                return true;
+            }
+            // An untyped const loses the suffixes of its initializer too, so it becomes abstract with them
+            const auto* user = sem->As<tint::sem::VariableUser>();
+            const auto* constant = user ? user->Variable()->Declaration()->As<tint::ast::Const>() : nullptr;
+            return constant && !constant->type && untyped(constant->initializer);
+        },
+        [&](const tint::ast::UnaryOpExpression* unary) {
+            return unary->op != tint::core::UnaryOp::kAddressOf && unary->op != tint::core::UnaryOp::kIndirection &&
+                   untyped(unary->expr);
+        },
+        [&](const tint::ast::BinaryExpression* binary) {
+            if (binary->IsComparison() || binary->IsLogical()) {
+                return false;
+            }
+            if (binary->op == tint::core::BinaryOp::kShiftLeft || binary->op == tint::core::BinaryOp::kShiftRight) {
+                return untyped(binary->lhs);
+            }
+            return untyped(binary->lhs) && untyped(binary->rhs);
+        },
+        [&](const tint::ast::MemberAccessorExpression* member) { return untyped(member->object); },
+        [&](const tint::ast::IndexAccessorExpression* index) { return untyped(index->object); },
+        [&](const tint::ast::CallExpression* call) {
+            const auto* sem = program.Sem().GetVal(call)->UnwrapMaterialize()->As<tint::sem::Call>();
+            if (!sem->Target()->Is<tint::sem::BuiltinFn>() && !IsInferringConstructor(call)) {
+                return false;
+            }
+            return std::all_of(call->args.begin(), call->args.end(), untyped);
+        },
+        [&](tint::Default) { return false; }
+    );
+}
+
+// The type a declaration infers from an untyped initializer of type `type`
+static bool IsDefaultType(const tint::core::type::Type* type, const tint::core::type::Type* declared) {
+    return tint::Switch(
+        type,
+        [&](const tint::core::type::Vector* vector) {
+            const auto* other = declared->As<tint::core::type::Vector>();
+            return other && other->Width() == vector->Width() && IsDefaultType(vector->Type(), other->Type());
+        },
+        [&](const tint::core::type::Matrix* matrix) {
+            const auto* other = declared->As<tint::core::type::Matrix>();
+            return other && other->Columns() == matrix->Columns() && other->Rows() == matrix->Rows() &&
+                   IsDefaultType(matrix->Type(), other->Type());
+        },
+        [&](const tint::core::type::Array* array) {
+            const auto* other = declared->As<tint::core::type::Array>();
+            return other && array->ConstantCount() && other->ConstantCount() == array->ConstantCount() &&
+                   IsDefaultType(array->ElemType(), other->ElemType());
+        },
+        [&](const tint::core::type::Bool*) { return declared->Is<tint::core::type::Bool>(); },
+        [&](tint::Default) {
+            if (type->IsAnyOf<tint::core::type::AbstractInt, tint::core::type::I32, tint::core::type::U32>()) {
+                return declared->Is<tint::core::type::I32>();
+            }
+            if (type->IsAnyOf<tint::core::type::AbstractFloat, tint::core::type::F32, tint::core::type::F16>()) {
+                return declared->Is<tint::core::type::F32>();
+            }
+            return false;
+        }
+    );
+}
+
+static bool IsElidable(const tint::Program& program, const tint::ast::Variable* variable) {
+    if (!variable->type || !variable->initializer) {
+        return false;
+    }
+    const auto* var = variable->As<tint::ast::Var>();
+    if (var && (var->declared_address_space || var->declared_access || !variable->attributes.IsEmpty())) {
+        return false;
+    }
+    const auto* sem = program.Sem().Get(variable);
+    if (!variable->IsAnyOf<tint::ast::Let, tint::ast::Const>() &&
+        !(var && sem->Is<tint::sem::LocalVariable>())) {
+        return false;
+    }
+
+    const auto* declared = sem->Type()->UnwrapRef();
+    const auto* type = program.Sem().GetVal(variable->initializer)->UnwrapMaterialize()->Type();
+    if (!IsUntyped(program, variable->initializer)) {
+        return type == declared;
+    }
+    return !variable->Is<tint::ast::Const>() && IsDefaultType(type, declared);
+}
+
+ElideDeclarationTypes::ApplyResult ElideDeclarationTypes::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto elided = false;
+    auto elide = [&](const tint::ast::Variable* variable) {
+        if (!IsElidable(program, variable)) {
+            return;
+        }
+        ctx.Replace(variable, [&ctx, variable]() -> const tint::ast::Variable* {
+            auto source = ctx.Clone(variable->source);
+            auto name = ctx.Clone(variable->name->symbol);
+            const auto* value = ctx.Clone(variable->initializer);
+            return tint::Switch(
+                variable,
+                [&](const tint::ast::Let*) -> const tint::ast::Variable* { return ctx.dst->Let(source, name, value); },
+                [&](const tint::ast::Const*) -> const tint::ast::Variable* {
+                    return ctx.dst->Const(source, name, value);
+                },
+                [&](tint::Default) -> const tint::ast::Variable* { return ctx.dst->Var(source, name, value); }
+            );
+        });
+        elided = true;
+    };
+    for (const auto* global : program.AST().GlobalVariables()) {
+        elide(global);
+    }
+    for (const auto* function : program.AST().Functions()) {
+        if (function->body) {
+            TraverseNodes<tint::ast::Variable>(function->body, elide);
+        }
+    }
+    if (!elided) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
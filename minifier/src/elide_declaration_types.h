@@ -0,0 +1,19 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Removes the type of lets, consts and function scope vars whose initializer would infer the same type. The writer
+// drops literal suffixes, so the type an initializer infers is taken as if it had none: `1u` infers i32. A const
+// keeps an abstract initializer abstract, so a const only loses its type if the initializer has it on its own.
+class ElideDeclarationTypes final : public tint::Castable<ElideDeclarationTypes, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/call_statement.h>
+#include <src/tint/lang/wgsl/ast/compound_assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/expression.h>
+#include <src/tint/lang/wgsl/ast/if_statement.h>
+#include <src/tint/lang/wgsl/ast/increment_decrement_statement.h>
+#include <src/tint/lang/wgsl/ast/return_statement.h>
+#include <src/tint/lang/wgsl/ast/statement.h>
+#include <src/tint/lang/wgsl/ast/switch_statement.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <vector>
+
+#include "traverser.h"
+
+namespace wgslx::minifier {
+
+using Expressions = std::vector<const tint::ast::Expression*>;
+
+// The expressions `stmt` evaluates before its own side effects and before running any nested block
+inline Expressions EvaluatedExpressions(const tint::ast::Statement* stmt) {
+    return tint::Switch(
+        stmt,
+        [](const tint::ast::VariableDeclStatement* s) {
+            return s->variable->initializer ? Expressions {s->variable->initializer} : Expressions {};
+        },
+        [](const tint::ast::AssignmentStatement* s) { return Expressions {s->lhs, s->rhs}; },
+        [](const tint::ast::CompoundAssignmentStatement* s) { return Expressions {s->lhs, s->rhs}; },
+        [](const tint::ast::IncrementDecrementStatement* s) { return Expressions {s->lhs}; },
+        [](const tint::ast::ReturnStatement* s) { return s->value ? Expressions {s->value} : Expressions {}; },
+        [](const tint::ast::IfStatement* s) { return Expressions {s->condition}; },
+        [](const tint::ast::SwitchStatement* s) { return Expressions {s->condition}; },
+        // The call itself happens after its arguments are evaluated
+        [](const tint::ast::CallStatement* s) { return Expressions(s->expr->args.begin(), s->expr->args.end()); },
+        [](tint::Default) { return Expressions {}; }
+    );
+}
+
+inline bool Contains(const tint::ast::Node* root, const tint::ast::Node* node) {
+    return !TraverseNodes<tint::ast::Node>(root, [&](const tint::ast::Node* n) {
+        return n == node ? TraverseAction::Stop : TraverseAction::Continue;
+    });
+}
+
+// Whether `node` is only evaluated depending on the left of a && or ||
+inline bool IsShortCircuited(const tint::ast::Expression* root, const tint::ast::Node* node) {
+    return !TraverseNodes<tint::ast::BinaryExpression>(root, [&](const tint::ast::BinaryExpression* binary) {
+        return binary->IsLogical() && Contains(binary->rhs, node) ? TraverseAction::Stop : TraverseAction::Continue;
+    });
+}
+
+// Whether `stmt` always evaluates `expr` before its own side effects
+inline bool IsEvaluatedFirst(const tint::ast::Statement* stmt, const tint::ast::Expression* expr) {
+    for (const auto* evaluated : EvaluatedExpressions(stmt)) {
+        if (Contains(evaluated, expr)) {
+            return !IsShortCircuited(evaluated, expr);
+        }
+    }
+    return false;
+}
+
+// The statement of `block` containing `stmt`
+inline const tint::ast::Statement* EnclosingStatement(
+    const tint::sem::Statement* stmt,
+    const tint::ast::BlockStatement* block
+) {
+    while (stmt && stmt->Parent()) {
+        if (stmt->Parent()->Declaration() == block) {
+            return stmt->Declaration();
+        }
+        stmt = stmt->Parent();
+    }
+    return nullptr;
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,121 @@
+#include "expressions.h"
+
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/bool_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/float_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/int_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/templated_identifier.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace wgslx::minifier {
+
+const tint::sem::ValueExpression* GetValue(const tint::Program& program, const tint::ast::Expression* expr) {
+    const auto* sem = program.Sem().Get(expr);
+    return sem ? sem->As<tint::sem::ValueExpression>() : nullptr;
+}
+
+using Pairs = std::vector<std::pair<const tint::ast::Expression*, const tint::ast::Expression*>>;
+
+// Compares `a` and `b` without their subexpressions, the pairs of those are added to `pending`
+static bool IsSameNode(
+    const tint::Program& program,
+    const tint::ast::Expression* a,
+    const tint::ast::Expression* b,
+    Pairs& pending
+) {
+    if (&a->TypeInfo() != &b->TypeInfo()) {
+        return false;
+    }
+    auto same = [&](const tint::ast::Expression* x, const tint::ast::Expression* y) {
+        pending.emplace_back(x, y);
+        return true;
+    };
+    return tint::Switch(
+        a,
+        [&](const tint::ast::IdentifierExpression* ident) {
+            const auto* other = b->As<tint::ast::IdentifierExpression>();
+            const auto* user = program.Sem().Get<tint::sem::VariableUser>(ident);
+            const auto* other_user = program.Sem().Get<tint::sem::VariableUser>(other);
+            if (user || other_user) {
+                return user && other_user && user->Variable() == other_user->Variable();
+            }
+            return ident->identifier->symbol == other->identifier->symbol &&
+                   !ident->identifier->Is<tint::ast::TemplatedIdentifier>() &&
+                   !other->identifier->Is<tint::ast::TemplatedIdentifier>();
+        },
+        [&](const tint::ast::IntLiteralExpression* literal) {
+            const auto* other = b->As<tint::ast::IntLiteralExpression>();
+            return literal->value == other->value && literal->suffix == other->suffix;
+        },
+        [&](const tint::ast::FloatLiteralExpression* literal) {
+            const auto* other = b->As<tint::ast::FloatLiteralExpression>();
+            return literal->value == other->value && std::signbit(literal->value) == std::signbit(other->value) &&
+                   literal->suffix == other->suffix;
+        },
+        [&](const tint::ast::BoolLiteralExpression* literal) {
+            return literal->value == b->As<tint::ast::BoolLiteralExpression>()->value;
+        },
+        [&](const tint::ast::BinaryExpression* binary) {
+            const auto* other = b->As<tint::ast::BinaryExpression>();
+            return binary->op == other->op && same(binary->lhs, other->lhs) && same(binary->rhs, other->rhs);
+        },
+        [&](const tint::ast::UnaryOpExpression* unary) {
+            const auto* other = b->As<tint::ast::UnaryOpExpression>();
+            return unary->op == other->op && same(unary->expr, other->expr);
+        },
+        [&](const tint::ast::MemberAccessorExpression* member) {
+            const auto* other = b->As<tint::ast::MemberAccessorExpression>();
+            return member->member->symbol == other->member->symbol && same(member->object, other->object);
+        },
+        [&](const tint::ast::IndexAccessorExpression* index) {
+            const auto* other = b->As<tint::ast::IndexAccessorExpression>();
+            return same(index->object, other->object) && same(index->index, other->index);
+        },
+        [&](const tint::ast::CallExpression* call) {
+            const auto* other = b->As<tint::ast::CallExpression>();
+            const auto* sem = GetValue(program, call);
+            const auto* other_sem = GetValue(program, other);
+            const auto* target = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+            const auto* other_target = other_sem ? other_sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+            if (!target || !other_target || target->Target() != other_target->Target() ||
+                call->args.Length() != other->args.Length()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < call->args.Length(); ++i) {
+                if (!same(call->args[i], other->args[i])) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        [&](tint::Default) { return false; }
+    );
+}
+
+bool IsSameExpression(const tint::Program& program, const tint::ast::Expression* a, const tint::ast::Expression* b) {
+    // The pairs left to compare are kept on the heap, so deep expressions don't recurse
+    Pairs pending {{a, b}};
+    while (!pending.empty()) {
+        auto [x, y] = pending.back();
+        pending.pop_back();
+        if (!IsSameNode(program, x, y, pending)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace wgslx::minifier
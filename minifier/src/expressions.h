@@ -0,0 +1,15 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/expression.h>
+#include <src/tint/lang/wgsl/program/program.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+namespace wgslx::minifier {
+
+// The semantic value of `expr`, or nullptr if it isn't a value, such as a type
+const tint::sem::ValueExpression* GetValue(const tint::Program& program, const tint::ast::Expression* expr);
+
+// Whether `a` and `b` are written the same and refer to the same declarations
+bool IsSameExpression(const tint::Program& program, const tint::ast::Expression* a, const tint::ast::Expression* b);
+
+}  // namespace wgslx::minifier
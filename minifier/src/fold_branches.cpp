@@ -0,0 +1,77 @@
+#include "fold_branches.h"
+
+#include <src/tint/lang/core/constant/value.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/if_statement.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::FoldBranches);
+
+namespace wgslx::minifier {
+
+// Returns the condition value, or nullptr if it isn't known at shader creation time
+static const tint::core::constant::Value* ConstantCondition(
+    const tint::Program& program,
+    const tint::ast::IfStatement* stmt
+) {
+    const auto* sem = program.Sem().GetVal(stmt->condition);
+    return sem ? sem->ConstantValue() : nullptr;
+}
+
+FoldBranches::ApplyResult FoldBranches::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto folded = false;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::IfStatement>(function->body, [&](const tint::ast::IfStatement* stmt) {
+            // `else if` is folded together with the first if of the chain
+            const auto* sem = program.Sem().Get(stmt);
+            const auto* block = sem && sem->Parent() ? sem->Parent()->Declaration()->As<tint::ast::BlockStatement>()
+                                                     : nullptr;
+            if (!block || !ConstantCondition(program, stmt)) {
+                return;
+            }
+
+            const tint::ast::Statement* taken = stmt;
+            while (const auto* branch = taken ? taken->As<tint::ast::IfStatement>() : nullptr) {
+                const auto* condition = ConstantCondition(program, branch);
+                if (!condition) {
+                    break;
+                }
+                taken = condition->ValueAs<bool>() ? branch->body : branch->else_statement;
+            }
+
+            if (taken) {
+                // The branch keeps its own block, so its declarations stay scoped
+                ctx.Replace(stmt, [&ctx, taken] { return ctx.Clone(taken); });
+            } else {
+                ctx.Remove(block->statements, stmt);
+            }
+            folded = true;
+        });
+    }
+    if (!folded) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Replaces if statements whose condition is a constant with the branch which is taken.
+class FoldBranches final : public tint::Castable<FoldBranches, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,292 @@
+#include "hoist_common_subexpressions.h"
+
+#include <src/tint/lang/core/builtin_fn.h>
+#include <src/tint/lang/core/type/pointer.h>
+#include <src/tint/lang/core/type/reference.h>
+#include <src/tint/lang/core/unary_op.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/bool_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/float_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/int_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/builtin_fn.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/function.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "evaluation.h"
+#include "expressions.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::HoistCommonSubexpressions);
+
+namespace wgslx::minifier {
+
+// Estimated bytes per node of an expression after renaming, and those of a let name and of `let =;`
+static constexpr std::size_t EstimatedNodeLength = 3;
+static constexpr std::size_t EstimatedNameLength = 2;
+static constexpr std::size_t DeclarationOverhead = 6;
+
+static std::string Address(const void* pointer) {
+    return std::to_string(reinterpret_cast<std::uintptr_t>(pointer));
+}
+
+// Builtins whose result only depends on their arguments, wherever they are called
+static bool IsHoistable(const tint::sem::BuiltinFn* builtin) {
+    return !builtin->HasSideEffects() && !builtin->IsBarrier() && !builtin->IsDerivative() &&
+           !builtin->IsTexture() && !builtin->IsAtomic() && !builtin->IsSubgroup() && !builtin->IsQuadSwap() &&
+           builtin->Fn() != tint::core::BuiltinFn::kWorkgroupUniformLoad;
+}
+
+// Numbers expressions so that those computing the same value, wherever they are in the function, get the same
+// number. Expressions which may not compute the same value, such as those reading variables, get no number.
+class ValueNumbering {
+ public:
+    explicit ValueNumbering(const tint::Program& program) : program_(program) {}
+
+    std::optional<std::size_t> Number(const tint::ast::Expression* expr) {
+        // Subexpressions are numbered when the walk leaves them, before the expressions containing them, so deep
+        // expressions don't recurse
+        struct Visitor {
+            ValueNumbering& numbering;
+
+            TraverseAction Enter(const tint::ast::Node* node) const {
+                const auto* e = node->As<tint::ast::Expression>();
+                return e && !numbering.cache_.contains(e) ? TraverseAction::Continue : TraverseAction::Skip;
+            }
+
+            void Leave(const tint::ast::Node* node) const {
+                const auto* e = node->As<tint::ast::Expression>();
+                auto key = numbering.Key(e);
+                std::optional<std::size_t> number;
+                if (key) {
+                    auto& numbers = numbering.numbers_;
+                    number = numbers.try_emplace(std::move(*key), numbers.size()).first->second;
+                }
+                numbering.cache_.emplace(e, number);
+            }
+        };
+
+        if (!cache_.contains(expr)) {
+            Traverse(expr, Visitor {*this});
+        }
+        return cache_.at(expr);
+    }
+
+ private:
+    const tint::Program& program_;
+    std::unordered_map<std::string, std::size_t> numbers_;
+    std::unordered_map<const tint::ast::Expression*, std::optional<std::size_t>> cache_;
+
+    // The subexpressions of `expr` are already numbered
+    std::optional<std::string> Key(const tint::ast::Expression* expr) {
+        const auto* sem = GetValue(program_, expr);
+        if (!sem || sem->Type()->IsAnyOf<tint::core::type::Reference, tint::core::type::Pointer>() ||
+            sem->Type()->IsAbstract()) {
+            return std::nullopt;
+        }
+
+        auto key = Address(sem->Type()) + ":";
+        auto append = [&](const tint::ast::Expression* child) {
+            auto number = cache_.at(child);
+            key += number ? std::to_string(*number) + "," : "";
+            return number.has_value();
+        };
+        auto valid = tint::Switch(
+            expr,
+            [&](const tint::ast::IdentifierExpression*) {
+                const auto* user = sem->UnwrapMaterialize()->As<tint::sem::VariableUser>();
+                if (!user || user->Variable()->Declaration()->Is<tint::ast::Var>()) {
+                    return false;
+                }
+                key += "v" + Address(user->Variable());
+                return true;
+            },
+            [&](const tint::ast::IntLiteralExpression* literal) {
+                key += "i" + std::to_string(literal->value);
+                return true;
+            },
+            [&](const tint::ast::FloatLiteralExpression* literal) {
+                key += "f" + std::to_string(std::bit_cast<std::uint64_t>(literal->value));
+                return true;
+            },
+            [&](const tint::ast::BoolLiteralExpression* literal) {
+                key += literal->value ? "true" : "false";
+                return true;
+            },
+            [&](const tint::ast::BinaryExpression* binary) {
+                key += "b" + std::to_string(static_cast<int>(binary->op)) + ",";
+                return append(binary->lhs) && append(binary->rhs);
+            },
+            [&](const tint::ast::UnaryOpExpression* unary) {
+                if (unary->op == tint::core::UnaryOp::kAddressOf || unary->op == tint::core::UnaryOp::kIndirection) {
+                    return false;
+                }
+                key += "u" + std::to_string(static_cast<int>(unary->op)) + ",";
+                return append(unary->expr);
+            },
+            [&](const tint::ast::MemberAccessorExpression* member) {
+                key += "m" + member->member->symbol.Name() + ",";
+                return append(member->object);
+            },
+            [&](const tint::ast::IndexAccessorExpression* index) {
+                key += "x,";
+                return append(index->object) && append(index->index);
+            },
+            [&](const tint::ast::CallExpression* call) {
+                const auto* target = sem->UnwrapMaterialize()->As<tint::sem::Call>()->Target();
+                if (target->Is<tint::sem::Function>()) {
+                    return false;
+                }
+                if (const auto* builtin = target->As<tint::sem::BuiltinFn>(); builtin && !IsHoistable(builtin)) {
+                    return false;
+                }
+                key += "c" + Address(target) + ",";
+                return std::all_of(call->args.begin(), call->args.end(), append);
+            },
+            [&](tint::Default) { return false; }
+        );
+        return valid ? std::optional(std::move(key)) : std::nullopt;
+    }
+};
+
+static std::size_t CountNodes(const tint::ast::Node* node) {
+    std::size_t count = 0;
+    TraverseNodes<tint::ast::Node>(node, [&](const tint::ast::Node*) { ++count; });
+    return count;
+}
+
+class Hoister {
+ public:
+    explicit Hoister(tint::program::CloneContext* ctx) : ctx_(ctx), program_(*ctx->src), numbering_(program_) {}
+
+    bool Run(const tint::ast::Function* function) {
+        std::unordered_map<std::size_t, std::vector<const tint::ast::Expression*>> occurrences;
+        std::vector<std::size_t> numbers;
+        TraverseNodes<tint::ast::Expression>(function->body, [&](const tint::ast::Expression* expr) {
+            const auto* sem = GetValue(program_, expr);
+            // Constants are folded instead, and a name alone is as short as the let would be
+            if (!sem || sem->ConstantValue() ||
+                expr->IsAnyOf<tint::ast::IdentifierExpression, tint::ast::LiteralExpression>()) {
+                return;
+            }
+            if (auto number = numbering_.Number(expr)) {
+                auto& list = occurrences[*number];
+                if (list.empty()) {
+                    numbers.push_back(*number);
+                }
+                list.push_back(expr);
+            }
+        });
+
+        // Larger expressions first, their subexpressions are hoisted with them
+        std::vector<std::pair<std::size_t, std::size_t>> candidates;
+        for (auto number : numbers) {
+            if (occurrences[number].size() > 1) {
+                candidates.emplace_back(CountNodes(occurrences[number].front()), number);
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+
+        auto hoisted = false;
+        for (auto [nodes, number] : candidates) {
+            std::vector<const tint::ast::Expression*> uses;
+            std::copy_if(
+                occurrences[number].begin(), occurrences[number].end(), std::back_inserter(uses),
+                [&](const tint::ast::Expression* expr) { return !covered_.contains(expr); }
+            );
+            auto length = nodes * EstimatedNodeLength;
+            auto declaration = length + DeclarationOverhead + EstimatedNameLength;
+            if (uses.size() < 2 || uses.size() * length <= declaration + uses.size() * EstimatedNameLength) {
+                continue;
+            }
+            hoisted = Hoist(uses) || hoisted;
+        }
+        return hoisted;
+    }
+
+ private:
+    tint::program::CloneContext* ctx_;
+    const tint::Program& program_;
+    ValueNumbering numbering_;
+    std::unordered_set<const tint::ast::Node*> covered_;
+
+    bool Hoist(const std::vector<const tint::ast::Expression*>& uses) {
+        const auto* first = GetValue(program_, uses.front())->Stmt();
+        const auto* parent = first ? first->Parent() : nullptr;
+        const auto* block = parent ? parent->Declaration()->As<tint::ast::BlockStatement>() : nullptr;
+        if (!block || !IsEvaluatedFirst(first->Declaration(), uses.front())) {
+            return false;
+        }
+        const auto& statements = block->statements;
+        auto position = std::find(statements.begin(), statements.end(), first->Declaration());
+        for (const auto* use : uses) {
+            const auto* stmt = EnclosingStatement(GetValue(program_, use)->Stmt(), block);
+            if (!stmt || std::find(position, statements.end(), stmt) == statements.end()) {
+                return false;
+            }
+        }
+
+        auto& b = *ctx_->dst;
+        auto name = b.Symbols().New("common");
+        ctx_->InsertBefore(statements, first->Declaration(), b.Decl(b.Let(name, ctx_->Clone(uses.front()))));
+        for (const auto* use : uses) {
+            ctx_->Replace(use, b.Expr(name));
+            TraverseNodes<tint::ast::Node>(use, [&](const tint::ast::Node* node) { covered_.insert(node); });
+        }
+        return true;
+    }
+};
+
+HoistCommonSubexpressions::ApplyResult HoistCommonSubexpressions::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    Hoister hoister(&ctx);
+    auto hoisted = false;
+    for (const auto* function : program.AST().Functions()) {
+        if (function->body) {
+            hoisted = hoister.Run(function) || hoisted;
+        }
+    }
+    if (!hoisted) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
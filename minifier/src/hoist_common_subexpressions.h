@@ -0,0 +1,22 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Hoists expressions repeated in a function into a let, when that is shorter. Only expressions of lets,
+// parameters, consts and literals are hoisted, calling nothing but value constructors, conversions and builtins
+// which neither have side effects nor depend on uniformity, so their value is the same wherever evaluated.
+// The let is declared before the statement evaluating the first occurrence, which must evaluate it
+// unconditionally, and every other occurrence must come after it in the same block.
+class HoistCommonSubexpressions final
+    : public tint::Castable<HoistCommonSubexpressions, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,146 @@
+#include "inline_constants.h"
+
+#include <src/tint/lang/core/constant/value.h>
+#include <src/tint/lang/core/number.h>
+#include <src/tint/lang/core/type/abstract_float.h>
+#include <src/tint/lang/core/type/abstract_int.h>
+#include <src/tint/lang/core/type/bool.h>
+#include <src/tint/lang/core/type/f16.h>
+#include <src/tint/lang/core/type/f32.h>
+#include <src/tint/lang/core/type/i32.h>
+#include <src/tint/lang/core/type/u32.h>
+#include <src/tint/lang/wgsl/ast/const.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/containers/hashmap.h>
+#include <src/tint/utils/rtti/switch.h>
+#include <src/tint/utils/symbol/symbol.h>
+
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <optional>
+
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::InlineConstants);
+
+namespace wgslx::minifier {
+
+// Renaming runs later and gives the most used declarations the shortest names
+static constexpr std::size_t EstimatedNameLength = 2;
+
+// `const ` `=` `;`
+static constexpr std::size_t DeclarationOverhead = 8;
+
+struct Literal {
+    std::function<const tint::ast::Expression*(tint::ProgramBuilder&)> create;
+    // The approximate printed length
+    std::size_t length;
+};
+
+template<typename T>
+static Literal NumberLiteral(T value) {
+    return {
+        .create = [value](tint::ProgramBuilder& builder) { return builder.Expr(value); },
+        .length = std::format("{}", value.value).size(),
+    };
+}
+
+// Non-negative scalars only, so the literal can't change how its surrounding is parsed. Abstract values get
+// unsuffixed literals and stay abstract.
+static std::optional<Literal> CreateLiteral(const tint::core::constant::Value* value) {
+    return tint::Switch(
+        value->Type(),
+        [&](const tint::core::type::Bool*) -> std::optional<Literal> {
+            auto b = value->ValueAs<bool>();
+            return Literal {
+                .create = [b](tint::ProgramBuilder& builder) { return builder.Expr(b); },
+                .length = b ? 4u : 5u,
+            };
+        },
+        [&](const tint::core::type::AbstractInt*) -> std::optional<Literal> {
+            auto v = value->ValueAs<tint::core::AInt>();
+            return v.value >= 0 ? std::optional(NumberLiteral(v)) : std::nullopt;
+        },
+        [&](const tint::core::type::I32*) -> std::optional<Literal> {
+            auto v = value->ValueAs<tint::core::i32>();
+            return v.value >= 0 ? std::optional(NumberLiteral(v)) : std::nullopt;
+        },
+        [&](const tint::core::type::U32*) -> std::optional<Literal> {
+            return NumberLiteral(value->ValueAs<tint::core::u32>());
+        },
+        [&](const tint::core::type::AbstractFloat*) -> std::optional<Literal> {
+            auto v = value->ValueAs<tint::core::AFloat>();
+            return v.value >= 0 && !std::signbit(v.value) ? std::optional(NumberLiteral(v)) : std::nullopt;
+        },
+        [&](const tint::core::type::F32*) -> std::optional<Literal> {
+            auto v = value->ValueAs<tint::core::f32>();
+            return v.value >= 0 && !std::signbit(v.value) ? std::optional(NumberLiteral(v)) : std::nullopt;
+        },
+        [&](const tint::core::type::F16*) -> std::optional<Literal> {
+            auto v = value->ValueAs<tint::core::f16>();
+            return v.value >= 0 && !std::signbit(v.value) ? std::optional(NumberLiteral(v)) : std::nullopt;
+        },
+        [&](tint::Default) -> std::optional<Literal> { return std::nullopt; }
+    );
+}
+
+InlineConstants::ApplyResult InlineConstants::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    // Identifiers the resolver doesn't record as users, or which name a shadowing declaration, make the count
+    // differ from the users of the const. Those consts are left alone.
+    tint::Hashmap<tint::Symbol, std::size_t, 64> names;
+    for (const auto* node : program.AST().GlobalDeclarations()) {
+        TraverseNodes<tint::ast::IdentifierExpression>(node, [&](const tint::ast::IdentifierExpression* expr) {
+            ++names.GetOrAdd(expr->identifier->symbol, [] { return std::size_t {0}; });
+        });
+    }
+
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto inlined = false;
+    for (const auto* global : program.AST().GlobalVariables()) {
+        const auto* constant = global->As<tint::ast::Const>();
+        const auto* sem = constant ? program.Sem().Get(constant) : nullptr;
+        const auto* value = sem && sem->Initializer() ? sem->Initializer()->ConstantValue() : nullptr;
+        auto literal = value ? CreateLiteral(value) : std::nullopt;
+        if (!literal) {
+            continue;
+        }
+
+        auto references = sem->Users().Length();
+        auto named = names.Get(constant->name->symbol);
+        if (!named || *named != references) {
+            continue;
+        }
+        auto kept = DeclarationOverhead + EstimatedNameLength + literal->length + references * EstimatedNameLength;
+        if (references * literal->length > kept) {
+            continue;
+        }
+
+        for (const auto* user : sem->Users()) {
+            ctx.Replace(user->Declaration(), literal->create(builder));
+        }
+        ctx.Remove(program.AST().GlobalDeclarations(), constant);
+        inlined = true;
+    }
+    if (!inlined) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
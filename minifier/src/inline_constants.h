@@ -0,0 +1,18 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Replaces the references of module scope scalar consts with a literal of their value, when the literals are
+// estimated to be shorter than the declaration and the references together. Inlined consts are removed.
+class InlineConstants final : public tint::Castable<InlineConstants, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,448 @@
+#include "inline_functions.h"
+
+#include <src/tint/lang/core/type/pointer.h>
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/call_statement.h>
+#include <src/tint/lang/wgsl/ast/const.h>
+#include <src/tint/lang/wgsl/ast/for_loop_statement.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/loop_statement.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/must_use_attribute.h>
+#include <src/tint/lang/wgsl/ast/override.h>
+#include <src/tint/lang/wgsl/ast/phony_expression.h>
+#include <src/tint/lang/wgsl/ast/return_statement.h>
+#include <src/tint/lang/wgsl/ast/switch_statement.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
+#include <src/tint/lang/wgsl/ast/while_statement.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/function.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/containers/hashset.h>
+#include <src/tint/utils/containers/vector.h>
+#include <src/tint/utils/rtti/switch.h>
+#include <src/tint/utils/symbol/symbol.h>
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::InlineFunctions);
+
+namespace wgslx::minifier {
+
+// Estimated bytes per node after renaming, and those of a name, of `let =;` and of `fn (){}`
+static constexpr std::size_t EstimatedNodeLength = 3;
+static constexpr std::size_t EstimatedNameLength = 2;
+static constexpr std::size_t DeclarationOverhead = 6;
+static constexpr std::size_t FunctionOverhead = 8;
+
+// `loop{}` with the last `break;`, and the `{=;break;}` an early return becomes
+static constexpr std::size_t LoopOverhead = 12;
+static constexpr std::size_t ReturnOverhead = 10;
+
+using Statements = tint::Vector<const tint::ast::Statement*, 8>;
+using Names = tint::Hashset<tint::Symbol, 16>;
+
+struct Site {
+    const tint::ast::CallExpression* call;
+    const tint::ast::Statement* stmt;
+    const tint::ast::BlockStatement* block;
+    // Whether the value of the call is used, rather than only its side effects
+    bool value;
+};
+
+struct Callee {
+    const tint::ast::Function* function;
+    // The only return, if any, is the last statement
+    bool single_exit;
+    std::size_t returns;
+    // Nodes of the body
+    std::size_t size;
+    // Parameters and local declarations, which get fresh names
+    std::vector<const tint::sem::Variable*> locals;
+    // Names referring to something outside the function, which must not be shadowed at a call site
+    std::vector<tint::Symbol> free_names;
+};
+
+static std::size_t CountNodes(const tint::ast::Node* node) {
+    std::size_t count = 0;
+    TraverseNodes<tint::ast::Node>(node, [&](const tint::ast::Node*) { ++count; });
+    return count;
+}
+
+// Whether `arg` can replace the uses of `param` rather than being bound to a let. A name without a reference type
+// can't change during the call. Constant arguments are always bound, substituted into the body they would turn its
+// expressions into constant ones, which fail on an out of bounds index or a division by zero even in a dead branch.
+static bool IsPassedThrough(
+    const tint::Program& program,
+    const tint::sem::Variable* param,
+    const tint::ast::Expression* arg
+) {
+    const auto* user = program.Sem().GetVal(arg)->UnwrapMaterialize()->As<tint::sem::VariableUser>();
+    if (!user || user->Type() != param->Type()) {
+        return false;
+    }
+    return !user->Variable()->Declaration()->IsAnyOf<tint::ast::Const, tint::ast::Override>();
+}
+
+static std::optional<Site> FindSite(const tint::sem::Call* call) {
+    const auto* sem_stmt = call->Stmt();
+    const auto* parent = sem_stmt ? sem_stmt->Parent() : nullptr;
+    const auto* block = parent ? parent->Declaration()->As<tint::ast::BlockStatement>() : nullptr;
+    if (!block) {
+        return std::nullopt;
+    }
+
+    const auto* expr = call->Declaration();
+    auto value = tint::Switch(
+        sem_stmt->Declaration(),
+        [&](const tint::ast::CallStatement* s) -> std::optional<bool> {
+            return s->expr == expr ? std::optional(false) : std::nullopt;
+        },
+        [&](const tint::ast::AssignmentStatement* s) -> std::optional<bool> {
+            if (s->rhs != expr) {
+                return std::nullopt;
+            }
+            if (s->lhs->Is<tint::ast::PhonyExpression>()) {
+                return false;
+            }
+            // The target is evaluated without side effects
+            return s->lhs->Is<tint::ast::IdentifierExpression>() ? std::optional(true) : std::nullopt;
+        },
+        [&](const tint::ast::VariableDeclStatement* s) -> std::optional<bool> {
+            return s->variable->initializer == expr ? std::optional(true) : std::nullopt;
+        },
+        [&](const tint::ast::ReturnStatement* s) -> std::optional<bool> {
+            return s->value == expr ? std::optional(true) : std::nullopt;
+        },
+        [&](tint::Default) -> std::optional<bool> { return std::nullopt; }
+    );
+    if (!value) {
+        return std::nullopt;
+    }
+    return Site {.call = expr, .stmt = sem_stmt->Declaration(), .block = block, .value = *value};
+}
+
+static std::optional<Callee> AnalyzeCallee(const tint::Program& program, const tint::ast::Function* function) {
+    if (function->IsEntryPoint() || !function->body) {
+        return std::nullopt;
+    }
+    for (const auto* attribute : function->attributes) {
+        if (!attribute->Is<tint::ast::MustUseAttribute>()) {
+            return std::nullopt;
+        }
+    }
+
+    std::vector<const tint::ast::ReturnStatement*> returns;
+    TraverseNodes<tint::ast::ReturnStatement>(function->body, [&](const tint::ast::ReturnStatement* ret) {
+        returns.push_back(ret);
+    });
+    const auto& statements = function->body->statements;
+    auto single_exit = returns.empty() || (returns.size() == 1 && statements.Back() == returns[0]);
+    if (!single_exit) {
+        // A break for an early return must leave the wrapping loop
+        for (const auto* ret : returns) {
+            for (const auto* s = program.Sem().Get(ret)->Parent(); s; s = s->Parent()) {
+                if (s->Declaration()->IsAnyOf<
+                        tint::ast::LoopStatement,
+                        tint::ast::ForLoopStatement,
+                        tint::ast::WhileStatement,
+                        tint::ast::SwitchStatement>()) {
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+
+    Callee callee {
+        .function = function,
+        .single_exit = single_exit,
+        .returns = returns.size(),
+        .size = CountNodes(function->body),
+    };
+    std::unordered_set<const tint::ast::Identifier*> local_names;
+    for (const auto* param : function->params) {
+        callee.locals.push_back(program.Sem().Get(param));
+    }
+    TraverseNodes<tint::ast::VariableDeclStatement>(function->body, [&](const tint::ast::VariableDeclStatement* decl) {
+        callee.locals.push_back(program.Sem().Get(decl->variable));
+    });
+    for (const auto* local : callee.locals) {
+        local_names.insert(local->Declaration()->name);
+        for (const auto* user : local->Users()) {
+            local_names.insert(user->Declaration()->identifier);
+        }
+    }
+
+    Names free_names;
+    TraverseIdentifiers(function, [&](const tint::ast::Identifier* ident) {
+        if (ident != function->name && !local_names.contains(ident) && free_names.Add(ident->symbol)) {
+            callee.free_names.push_back(ident->symbol);
+        }
+    });
+    return callee;
+}
+
+class Inliner {
+ public:
+    explicit Inliner(tint::program::CloneContext* ctx) : ctx_(ctx), b_(*ctx->dst) {}
+
+    bool Run() {
+        std::unordered_set<const tint::ast::Function*> inlined;
+        std::unordered_set<const tint::ast::Function*> callers;
+        for (const auto* function : ctx_->src->AST().Functions()) {
+            auto callee = AnalyzeCallee(*ctx_->src, function);
+            auto sites = callee ? FindSites(*callee) : std::nullopt;
+            if (!sites || sites->empty() || callers.contains(function)) {
+                continue;
+            }
+            if (!Shrinks(*callee, *sites)) {
+                continue;
+            }
+            auto caller_inlined = false;
+            for (const auto* call : ctx_->src->Sem().Get(function)->CallSites()) {
+                caller_inlined = caller_inlined || inlined.contains(call->Stmt()->Function()->Declaration());
+            }
+            if (caller_inlined) {
+                continue;
+            }
+
+            for (const auto* call : ctx_->src->Sem().Get(function)->CallSites()) {
+                callers.insert(call->Stmt()->Function()->Declaration());
+            }
+            for (const auto& site : *sites) {
+                Inline(*callee, site);
+            }
+            inlined.insert(function);
+        }
+        return !inlined.empty();
+    }
+
+ private:
+    tint::program::CloneContext* ctx_;
+    tint::ProgramBuilder& b_;
+    std::unordered_map<const tint::ast::Function*, Names> declared_names_;
+
+    // Every call site must be inlinable, otherwise the function stays and inlining only costs bytes
+    std::optional<std::vector<Site>> FindSites(const Callee& callee) {
+        std::vector<Site> sites;
+        for (const auto* call : ctx_->src->Sem().Get(callee.function)->CallSites()) {
+            auto site = FindSite(call);
+            if (!site) {
+                return std::nullopt;
+            }
+            const auto& names = DeclaredNames(call->Stmt()->Function()->Declaration());
+            for (auto symbol : callee.free_names) {
+                if (names.Contains(symbol)) {
+                    return std::nullopt;
+                }
+            }
+            // A handle can't be bound to a let, so it must be passed through
+            const auto& params = callee.function->params;
+            for (std::size_t i = 0; i < params.Length(); ++i) {
+                const auto* param = ctx_->src->Sem().Get(params[i]);
+                if (!param->Type()->IsConstructible() && !param->Type()->Is<tint::core::type::Pointer>() &&
+                    !IsPassedThrough(*ctx_->src, param, site->call->args[i])) {
+                    return std::nullopt;
+                }
+            }
+            sites.push_back(*site);
+        }
+        return sites;
+    }
+
+    // Whether the inlined bodies are estimated to be shorter than the function and its calls. Arguments are counted
+    // with the calls, and with their lets or each use they are passed through to.
+    bool Shrinks(const Callee& callee, const std::vector<Site>& sites) const {
+        const auto& program = *ctx_->src;
+        const auto* function = callee.function;
+        auto kept = FunctionOverhead + EstimatedNameLength + CountNodes(function) * EstimatedNodeLength;
+        std::size_t inlined = 0;
+        for (const auto& site : sites) {
+            kept += CountNodes(site.call) * EstimatedNodeLength;
+            inlined += callee.size * EstimatedNodeLength;
+            if (!callee.single_exit) {
+                inlined += LoopOverhead + callee.returns * ReturnOverhead;
+                if (site.value) {
+                    inlined += DeclarationOverhead + EstimatedNameLength +
+                               CountNodes(function->return_type.expr) * EstimatedNodeLength;
+                }
+            }
+            for (std::size_t i = 0; i < function->params.Length(); ++i) {
+                const auto* param = program.Sem().Get(function->params[i]);
+                auto arg = CountNodes(site.call->args[i]) * EstimatedNodeLength;
+                if (!IsPassedThrough(program, param, site.call->args[i])) {
+                    inlined += DeclarationOverhead + EstimatedNameLength + arg +
+                               CountNodes(function->params[i]->type.expr) * EstimatedNodeLength;
+                    continue;
+                }
+                // The uses are in the body, which was counted with the name
+                for (const auto* user : param->Users()) {
+                    kept += CountNodes(user->Declaration()) * EstimatedNodeLength;
+                    inlined += arg;
+                }
+            }
+        }
+        return inlined < kept;
+    }
+
+    const Names& DeclaredNames(const tint::ast::Function* function) {
+        auto [iter, inserted] = declared_names_.try_emplace(function);
+        if (inserted) {
+            for (const auto* param : function->params) {
+                iter->second.Add(param->name->symbol);
+            }
+            TraverseNodes<tint::ast::Variable>(function->body, [&](const tint::ast::Variable* variable) {
+                iter->second.Add(variable->name->symbol);
+            });
+        }
+        return iter->second;
+    }
+
+    void Inline(const Callee& callee, const Site& site) {
+        const auto* function = callee.function;
+
+        // The body is cloned once per call site, with the locals renamed and the passed through arguments substituted
+        tint::program::CloneContext body(&b_, ctx_->src, false);
+        body.ReplaceAll([this](tint::Symbol symbol) { return ctx_->Clone(symbol); });
+        std::unordered_set<const tint::sem::Variable*> passed;
+        for (std::size_t i = 0; i < function->params.Length(); ++i) {
+            const auto* param = ctx_->src->Sem().Get(function->params[i]);
+            const auto* arg = site.call->args[i];
+            if (!IsPassedThrough(*ctx_->src, param, arg)) {
+                continue;
+            }
+            passed.insert(param);
+            for (const auto* user : param->Users()) {
+                body.Replace(user->Declaration(), [this, arg] { return ctx_->Clone(arg); });
+            }
+        }
+        std::unordered_map<const tint::sem::Variable*, tint::Symbol> fresh;
+        for (const auto* local : callee.locals) {
+            if (passed.contains(local)) {
+                continue;
+            }
+            auto symbol = b_.Symbols().New(local->Declaration()->name->symbol.Name());
+            fresh.emplace(local, symbol);
+            body.Replace(local->Declaration()->name, b_.Ident(symbol));
+            for (const auto* user : local->Users()) {
+                body.Replace(user->Declaration(), b_.Expr(symbol));
+            }
+        }
+
+        Statements statements;
+        for (std::size_t i = 0; i < function->params.Length(); ++i) {
+            const auto* param = function->params[i];
+            if (passed.contains(ctx_->src->Sem().Get(param))) {
+                continue;
+            }
+            statements.Push(b_.Decl(b_.Let(
+                fresh.at(ctx_->src->Sem().Get(param)),
+                tint::ast::Type {body.Clone(param->type.expr)},
+                ctx_->Clone(site.call->args[i])
+            )));
+        }
+
+        const tint::ast::Expression* result = nullptr;
+        if (callee.single_exit) {
+            for (const auto* stmt : function->body->statements) {
+                if (const auto* ret = stmt->As<tint::ast::ReturnStatement>()) {
+                    result = ret->value ? ReturnValue(body, function, ret->value) : nullptr;
+                } else {
+                    statements.Push(body.Clone(stmt));
+                }
+            }
+        } else {
+            result = InlineLoop(body, function, site.value, statements);
+        }
+
+        for (const auto* stmt : statements) {
+            ctx_->InsertBefore(site.block->statements, site.stmt, stmt);
+        }
+        if (site.value) {
+            ctx_->Replace(site.call, result);
+        } else if (result) {
+            // Keep the evaluation of the value, RemovePureCalls drops it if it has no side effects
+            ctx_->Replace(site.stmt, b_.Assign(b_.Phony(), result));
+        } else {
+            ctx_->Remove(site.block->statements, site.stmt);
+        }
+    }
+
+    // `var r: T; loop { ...; r = e; break; ... }` for functions returning early. Returns `r` if the value is used.
+    const tint::ast::Expression* InlineLoop(
+        tint::program::CloneContext& body,
+        const tint::ast::Function* function,
+        bool value,
+        Statements& statements
+    ) {
+        std::optional<tint::Symbol> result;
+        if (value) {
+            result = b_.Symbols().New("result");
+            statements.Push(b_.Decl(b_.Var(*result, tint::ast::Type {body.Clone(function->return_type.expr)})));
+        }
+
+        TraverseNodes<tint::ast::ReturnStatement>(function->body, [&](const tint::ast::ReturnStatement* ret) {
+            body.Replace(ret, [&, ret]() -> const tint::ast::Statement* {
+                if (!ret->value) {
+                    return b_.Break();
+                }
+                const auto* target = result ? b_.Expr(*result) : b_.Phony();
+                return b_.Block(b_.Assign(target, body.Clone(ret->value)), b_.Break());
+            });
+        });
+
+        Statements loop;
+        for (const auto* stmt : function->body->statements) {
+            loop.Push(body.Clone(stmt));
+        }
+        if (!function->body->statements.Back()->Is<tint::ast::ReturnStatement>()) {
+            loop.Push(b_.Break());
+        }
+        statements.Push(b_.Loop(b_.Block(std::move(loop))));
+        return result ? b_.Expr(*result) : nullptr;
+    }
+
+    // An abstract value would have been converted to the return type by the call
+    const tint::ast::Expression* ReturnValue(
+        tint::program::CloneContext& body,
+        const tint::ast::Function* function,
+        const tint::ast::Expression* value
+    ) {
+        const auto* sem = ctx_->src->Sem().GetVal(value);
+        const auto* cloned = body.Clone(value);
+        if (sem && sem->UnwrapMaterialize()->Type()->IsAbstract()) {
+            return b_.Call(tint::ast::Type {body.Clone(function->return_type.expr)}, cloned);
+        }
+        return cloned;
+    }
+};
+
+InlineFunctions::ApplyResult InlineFunctions::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+    if (!Inliner(&ctx).Run()) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
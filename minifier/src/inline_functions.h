@@ -0,0 +1,24 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Inlines functions at every call site, when the inlined bodies are estimated to be shorter than the function and its
+// calls. Calls are inlined when they are a whole statement, the initializer of a declaration, the value of a return
+// or assigned to a variable. Parameters become lets, unless the argument is the name of a runtime value which can be
+// used as is, and locals get fresh names. Handles can't be bound to lets, so those must be passed through.
+// Functions returning early are wrapped in a loop, where each return breaks out. The inlined functions are left to
+// RemoveUseless.
+//
+// Callers of an inlined function aren't inlined in the same run, they would be inlined with the original calls.
+class InlineFunctions final : public tint::Castable<InlineFunctions, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,142 @@
+#include "inline_lets.h"
+
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/let.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/containers/hashset.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#include "evaluation.h"
+#include "purity.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::InlineLets);
+
+namespace wgslx::minifier {
+
+using Names = tint::Hashset<tint::Symbol, 8>;
+// The names each inlined let brings to its use, including those of the lets inlined into its initializer
+using Inlined = std::unordered_map<const tint::ast::Variable*, Names>;
+
+// The names `expr` refers to once the lets inlined into it are substituted. Those lets were collected when they were
+// inlined, so long chains of lets are neither walked again nor recursed into.
+static Names CollectNames(const tint::Program& program, const Inlined& inlined, const tint::ast::Expression* expr) {
+    Names names;
+    TraverseNodes<tint::ast::IdentifierExpression>(expr, [&](const tint::ast::IdentifierExpression* ident) {
+        names.Add(ident->identifier->symbol);
+        const auto* user = program.Sem().Get<tint::sem::VariableUser>(ident);
+        auto iter = user ? inlined.find(user->Variable()->Declaration()) : inlined.end();
+        if (iter != inlined.end()) {
+            for (auto symbol : iter->second) {
+                names.Add(symbol);
+            }
+        }
+    });
+    return names;
+}
+
+static bool IsInlinable(
+    const tint::Program& program,
+    const Purity& purity,
+    const Inlined& inlined,
+    const tint::ast::BlockStatement* block,
+    std::size_t index,
+    Names& names
+) {
+    const auto* decl = block->statements[index]->As<tint::ast::VariableDeclStatement>();
+    if (!decl || !decl->variable->Is<tint::ast::Let>()) {
+        return false;
+    }
+    const auto* variable = program.Sem().Get(decl->variable);
+    const auto* init = program.Sem().GetVal(decl->variable->initializer);
+    // The initializer must have the type of the let on its own, an abstract value would materialize differently
+    if (variable->Users().Length() != 1 || init->UnwrapMaterialize()->Type() != variable->Type() ||
+        !purity.IsPure(decl->variable->initializer)) {
+        return false;
+    }
+
+    const auto* use = variable->Users()[0];
+    const auto* stmt = EnclosingStatement(use->Stmt(), block);
+    if (!stmt) {
+        return false;
+    }
+    const auto& statements = block->statements;
+    auto iter = std::find(statements.begin() + index + 1, statements.end(), stmt);
+    if (iter == statements.end()) {
+        return false;
+    }
+    // A declaration between the let and its use may shadow a name of the initializer
+    names = CollectNames(program, inlined, decl->variable->initializer);
+    for (auto between = statements.begin() + index + 1; between != iter; ++between) {
+        const auto* other = (*between)->As<tint::ast::VariableDeclStatement>();
+        if (!other || (other->variable->initializer && !purity.IsPure(other->variable->initializer)) ||
+            names.Contains(other->variable->name->symbol)) {
+            return false;
+        }
+    }
+    auto shadowed = false;
+    TraverseNodes<tint::ast::Variable>(stmt, [&](const tint::ast::Variable* variable) {
+        shadowed = shadowed || names.Contains(variable->name->symbol);
+    });
+    if (shadowed) {
+        return false;
+    }
+
+    for (const auto* expr : EvaluatedExpressions(stmt)) {
+        if (!purity.IsPure(expr)) {
+            return false;
+        }
+    }
+    return IsEvaluatedFirst(stmt, use->Declaration());
+}
+
+InlineLets::ApplyResult InlineLets::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    Purity purity(program);
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    Inlined inlined;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::BlockStatement>(function->body, [&](const tint::ast::BlockStatement* block) {
+            for (std::size_t i = 0; i < block->statements.Length(); ++i) {
+                Names names;
+                if (!IsInlinable(program, purity, inlined, block, i, names)) {
+                    continue;
+                }
+                const auto* decl = block->statements[i]->As<tint::ast::VariableDeclStatement>();
+                const auto* use = program.Sem().Get(decl->variable)->Users()[0];
+                // Cloned lazily, so lets inlined into this initializer are substituted too
+                ctx.Replace(use->Declaration(), [&ctx, decl] { return ctx.Clone(decl->variable->initializer); });
+                ctx.Remove(block->statements, decl);
+                inlined.emplace(decl->variable, std::move(names));
+            }
+        });
+    }
+    if (inlined.empty()) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Substitutes function scope lets with a single use into that use, when the initializer has no side effects. The
+// use must be evaluated by a later statement of the same block, with only pure declarations in between, before
+// anything with side effects in that statement and not on the right of a short-circuiting operator, so evaluation
+// order and uniformity are kept. No declaration up to the use may shadow a name the initializer refers to.
+class InlineLets final : public tint::Castable<InlineLets, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
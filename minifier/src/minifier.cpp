@@ -1,5 +1,7 @@
 #include "minifier/minifier.h"
 
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/module.h>
 #include <src/tint/lang/wgsl/ast/transform/fold_constants.h>
 #include <src/tint/lang/wgsl/ast/transform/manager.h>
 #include <src/tint/lang/wgsl/ast/transform/remove_unreachable_statements.h>
@@ -7,13 +9,32 @@
 #include <src/tint/lang/wgsl/writer/writer.h>
 #include <src/tint/utils/diagnostic/diagnostic.h>
 
+#include <algorithm>
+#include <memory>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/filter.hpp>
 #include <range/v3/view/join.hpp>
 #include <range/v3/view/transform.hpp>
+#include <string>
+#include <vector>
 
+#include "canonicalize_swizzles.h"
+#include "elide_declaration_types.h"
+#include "fold_branches.h"
+#include "hoist_common_subexpressions.h"
+#include "inline_constants.h"
+#include "inline_functions.h"
+#include "inline_lets.h"
+#include "promote_variables.h"
+#include "prune_struct_members.h"
+#include "remove_identity_conversions.h"
+#include "remove_pure_calls.h"
 #include "remove_useless.h"
 #include "rename_identifiers.h"
+#include "shorten_assignments.h"
+#include "shorten_constructors.h"
+#include "simplify_algebra.h"
+#include "substitute_overrides.h"
 
 namespace wgslx::minifier {
 
@@ -31,37 +52,109 @@ static Result GenerateError(const tint::diag::List& diagnostics) {
     };
 }
 
-Result Minify(std::string_view data, const Options& options) {
-    // Parse
-    tint::Source::File file(DefaultPath, data);
-    auto input = tint::wgsl::reader::Parse(
-        &file,
+static tint::Program Parse(const tint::Source::File* file) {
+    return tint::wgsl::reader::Parse(
+        file,
         {
             .allowed_features = tint::wgsl::AllowedFeatures::Everything(),
         }
     );
-    if (input.Diagnostics().ContainsErrors()) {
-        return GenerateError(input.Diagnostics());
+}
+
+// The first of `names` which isn't an entry point of `program`, since a typo would silently remove everything
+static const std::string* FindUnknownEntryPoint(const tint::Program& program, const std::vector<std::string>& names) {
+    for (const auto& name : names) {
+        const auto& functions = program.AST().Functions();
+        if (std::none_of(functions.begin(), functions.end(), [&](const tint::ast::Function* function) {
+                return function->IsEntryPoint() && function->name->symbol.Name() == name;
+            })) {
+            return &name;
+        }
+    }
+    return nullptr;
+}
+
+static Result RunTransforms(const tint::Program& input, const Options& options, const std::string* entry_point) {
+    if (const auto* unknown = FindUnknownEntryPoint(input, options.entry_points)) {
+        return {
+            .failure_message = "unknown entry point '" + *unknown + "'",
+            .failed = true,
+        };
     }
 
-    // Transform
+    auto entry_points = entry_point ? std::vector<std::string> {*entry_point} : options.entry_points;
+    auto keep_entry_points = !entry_points.empty();
+
     tint::ast::transform::Manager transform_manager;
     tint::ast::transform::DataMap in_data;
     tint::ast::transform::DataMap out_data;
+    if (keep_entry_points) {
+        in_data.Add<RemoveUseless::Config>(std::move(entry_points));
+    }
+    if (!options.overrides.empty()) {
+        transform_manager.Add<SubstituteOverrides>();
+        in_data.Add<SubstituteOverrides::Config>(SubstituteOverrides::Values(options.overrides));
+    }
+    if (options.promote_variables) {
+        transform_manager.Add<PromoteVariables>();
+    }
+    if (options.fold_branches) {
+        transform_manager.Add<FoldBranches>();
+    }
     if (options.remove_unreachable_statements) {
         transform_manager.Add<tint::ast::transform::RemoveUnreachableStatements>();
     }
     if (options.fold_constants) {
         transform_manager.Add<tint::ast::transform::FoldConstants>();
     }
-    if (options.remove_useless) {
+    if (options.simplify_algebra) {
+        transform_manager.Add<SimplifyAlgebra>();
+    }
+    if (options.shorten_constructors) {
+        transform_manager.Add<ShortenConstructors>();
+    }
+    if (options.inline_constants) {
+        transform_manager.Add<InlineConstants>();
+    }
+    if (options.inline_functions) {
+        transform_manager.Add<InlineFunctions>();
+    }
+    if (options.canonicalize_swizzles) {
+        transform_manager.Add<CanonicalizeSwizzles>();
+    }
+    if (options.remove_identity_conversions) {
+        transform_manager.Add<RemoveIdentityConversions>();
+    }
+    if (options.inline_lets) {
+        transform_manager.Add<InlineLets>();
+    }
+    if (options.hoist_common_subexpressions) {
+        transform_manager.Add<HoistCommonSubexpressions>();
+    }
+    if (options.remove_pure_calls) {
+        transform_manager.Add<RemovePureCalls>();
+    }
+    if (options.remove_useless || keep_entry_points) {
         transform_manager.Add<RemoveUseless>();
     }
+    if (options.prune_struct_members) {
+        transform_manager.Add<PruneStructMembers>();
+    }
+    if (options.shorten_assignments) {
+        transform_manager.Add<ShortenAssignments>();
+    }
+    if (options.elide_declaration_types) {
+        transform_manager.Add<ElideDeclarationTypes>();
+    }
     if (options.rename_identifiers) {
         transform_manager.Add<RenameIdentifiers>();
     }
 
     auto output = transform_manager.Run(input, in_data, out_data);
+    // A pass producing an invalid program is a bug, or a configuration the input can't take
+    if (!output.IsValid()) {
+        return GenerateError(output.Diagnostics());
+    }
 
     std::unordered_map<std::string, std::string> remappings;
     if (options.rename_identifiers) {
@@ -74,4 +167,52 @@ Result Minify(std::string_view data, const Options& options) {
     };
 }
 
+Result Minify(std::string_view data, const Options& options) {
+    auto file = std::make_unique<tint::Source::File>(DefaultPath, data);
+    auto input = Parse(file.get());
+    if (input.Diagnostics().ContainsErrors()) {
+        return GenerateError(input.Diagnostics());
+    }
+
+    auto result = RunTransforms(input, options, nullptr);
+    result.file = std::move(file);
+    return result;
+}
+
+SplitResult MinifyEntryPoints(std::string_view data, const Options& options) {
+    auto file = std::make_unique<tint::Source::File>(DefaultPath, data);
+    auto input = Parse(file.get());
+    if (input.Diagnostics().ContainsErrors()) {
+        auto error = GenerateError(input.Diagnostics());
+        return {
+            .failure_message = std::move(error.failure_message),
+            .failed = true,
+        };
+    }
+
+    if (const auto* unknown = FindUnknownEntryPoint(input, options.entry_points)) {
+        return {
+            .failure_message = "unknown entry point '" + *unknown + "'",
+            .failed = true,
+        };
+    }
+
+    // Every module starts from the same parsed program, only the kept entry point differs
+    SplitResult split;
+    for (const auto* function : input.AST().Functions()) {
+        if (!function->IsEntryPoint()) {
+            continue;
+        }
+        auto name = function->name->symbol.Name();
+        if (!options.entry_points.empty() &&
+            std::find(options.entry_points.begin(), options.entry_points.end(), name) == options.entry_points.end()) {
+            continue;
+        }
+        auto result = RunTransforms(input, options, &name);
+        split.entry_points.push_back({.entry_point = std::move(name), .result = std::move(result)});
+    }
+    split.file = std::move(file);
+    return split;
+}
+
 }  // namespace wgslx::minifier
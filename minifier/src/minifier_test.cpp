@@ -1,9 +1,12 @@
 #include "minifier/minifier.h"
 
 #include <gmock/gmock.h>
+#include <pthread.h>
 #include <src/tint/lang/wgsl/program/program.h>
 #include <src/tint/lang/wgsl/writer/writer.h>
 
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace wgslx::minifier {
@@ -13,6 +16,48 @@ static std::string Write(const tint::Program& program) {
     return result->wgsl;
 }
 
+// Options which run nothing, tests turn on the passes they check
+static Options NoPasses() {
+    return {
+        .rename_identifiers = false,
+        .remove_unreachable_statements = false,
+        .remove_useless = false,
+        .fold_constants = false,
+        .promote_variables = false,
+        .fold_branches = false,
+        .simplify_algebra = false,
+        .shorten_constructors = false,
+        .inline_constants = false,
+        .inline_functions = false,
+        .canonicalize_swizzles = false,
+        .remove_identity_conversions = false,
+        .inline_lets = false,
+        .hoist_common_subexpressions = false,
+        .remove_pure_calls = false,
+        .prune_struct_members = false,
+        .shorten_assignments = false,
+        .elide_declaration_types = false,
+    };
+}
+
+// The stack size the WASM build is linked with
+static constexpr std::size_t WasmStackSize = 1024 * 1024;
+
+// Runs `block` on a thread with a stack of `size` bytes
+static void RunWithStackSize(std::size_t size, std::function<void()> block) {
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, size);
+    pthread_t thread;
+    auto run = [](void* arg) -> void* {
+        (*static_cast<std::function<void()>*>(arg))();
+        return nullptr;
+    };
+    ASSERT_EQ(pthread_create(&thread, &attributes, run, &block), 0);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attributes);
+}
+
 TEST(minifier, Rename) {
     auto result = Minify(
         R"(
@@ -64,6 +109,19 @@ TEST(minifier, RenameSkipKeywords) {
             .remove_unreachable_statements = false,
             .remove_useless = false,
             .fold_constants = false,
+            .promote_variables = false,
+            .fold_branches = false,
+            .simplify_algebra = false,
+            .shorten_constructors = false,
+            .inline_constants = false,
+            .canonicalize_swizzles = false,
+            .remove_identity_conversions = false,
+            .inline_lets = false,
+            .hoist_common_subexpressions = false,
+            .remove_pure_calls = false,
+            .prune_struct_members = false,
+            .shorten_assignments = false,
+            .elide_declaration_types = false,
         }
     );
     EXPECT_FALSE(result.failed);
@@ -160,9 +218,1503 @@ TEST(minifier, RemoveUselessVar) {
     EXPECT_FALSE(result.failed);
     EXPECT_EQ(
         Write(result.program),
-        "@vertex\nfn c() -> @builtin(position) vec4f {\n  let d = 2.0f;\n  return ((vec4<f32>(1.0f) / d) / 2.0f);\n}\n"
+        "@vertex\nfn c() -> @builtin(position) vec4f {\n  return vec4<f32>(0.25f);\n}\n"
     );
     EXPECT_THAT(result.remappings, testing::UnorderedElementsAre(testing::Pair("vs1", "c")));
 }
 
+TEST(minifier, RemoveUselessKeepTemplateArgument) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = Minify(
+        R"(
+const N = 4;
+const M = 8;
+
+@vertex fn vs1() -> @builtin(position) vec4f {
+    var a: array<f32, N>;
+    return vec4f(a[0]);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const N = 4;
+
+@vertex
+fn vs1() -> @builtin(position) vec4f {
+  var a : array<f32, N>;
+  return vec4f(a[0]);
+}
+)"
+    );
+}
+
+TEST(minifier, DeepInput) {
+    // Machine generated chains and nesting must not overflow the stack of the WASM build. Tint itself limits
+    // statement nesting to 127.
+    std::string input = "fn f(x: f32) -> f32 { var a = x";
+    for (auto i = 0; i < 2000; ++i) {
+        input += " + x";
+    }
+    input += "; let l0 = a;";
+    for (auto i = 1; i < 2000; ++i) {
+        input += "let l" + std::to_string(i) + " = l" + std::to_string(i - 1) + " * 0.5 + x;";
+    }
+    input += "a = l1999;";
+    for (auto i = 0; i < 60; ++i) {
+        input += "if (a > 0) { let b" + std::to_string(i) + " = a; a = a * 0.5;";
+    }
+    for (auto i = 0; i < 60; ++i) {
+        input += "}";
+    }
+    input += "return a; }\n@vertex fn vs1() -> @builtin(position) vec4f { return vec4f(f(1)); }";
+
+    RunWithStackSize(WasmStackSize, [&] {
+        auto result = Minify(input, {});
+        ASSERT_FALSE(result.failed) << result.failure_message;
+    });
+}
+
+TEST(minifier, RemoveUselessGlobals) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = Minify(
+        R"(
+struct Light { color: vec3f }
+struct Lights { lights: array<Light, 4> }
+struct Unused { lights: Lights }
+alias Color = vec4f;
+alias UnusedAlias = vec3f;
+
+@group(0) @binding(0) var<uniform> lights: Lights;
+@group(0) @binding(1) var<uniform> unused_binding: vec4f;
+var<private> unused_private: f32;
+var<workgroup> unused_workgroup: array<f32, 64>;
+override unused_override: f32 = 1.0;
+
+@fragment fn fs() -> @location(0) Color {
+    return Color(lights.lights[0].color, 1);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    EXPECT_EQ(
+        Write(result.program),
+        R"(struct Light {
+  color : vec3f,
+}
+
+struct Lights {
+  lights : array<Light, 4>,
+}
+
+alias Color = vec4f;
+
+@group(0) @binding(0) var<uniform> lights : Lights;
+
+@fragment
+fn fs() -> @location(0) Color {
+  return Color(lights.lights[0].color, 1);
+}
+)"
+    );
+}
+
+TEST(minifier, RemoveUselessNestedLocals) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = Minify(
+        R"(
+var<private> counter: i32;
+
+fn next() -> i32 {
+    counter += 1;
+    return counter;
+}
+
+fn f(x: i32) -> i32 {
+    var a = 0;
+    var b = x;
+    for (var i = 0; i < x; i++) {
+        let t = i * 2;
+        b = t;
+        a += i;
+    }
+    if (x > 0) {
+        var c = next();
+        loop {
+            let d = a;
+            break;
+        }
+    }
+    a = 5;
+    a = 6;
+    return a;
+}
+
+@compute @workgroup_size(1) fn main() {
+    _ = f(1);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `t` is only read by a store to `b`, and `a = 5;` is overwritten. The call initializing `c` is kept.
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> counter : i32;
+
+fn next() -> i32 {
+  counter += 1;
+  return counter;
+}
+
+fn f(x : i32) -> i32 {
+  var a = 0;
+  for(var i = 0; (i < x); i++) {
+    a += i;
+  }
+  if ((x > 0)) {
+    _ = next();
+    loop {
+      break;
+    }
+  }
+  a = 6;
+  return a;
+}
+
+@compute @workgroup_size(1)
+fn main() {
+  _ = f(1);
+}
+)"
+    );
+}
+
+TEST(minifier, RemoveUselessParameters) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = Minify(
+        R"(
+var<private> counter: i32;
+
+fn next() -> i32 {
+    counter += 1;
+    return counter;
+}
+
+fn f(a: i32, unused: i32, b: i32) -> i32 {
+    return a + b;
+}
+
+fn g(a: i32, unused: i32) -> i32 {
+    return a;
+}
+
+@group(0) @binding(0) var<storage, read_write> output: array<i32, 2>;
+
+@compute @workgroup_size(1) fn main() {
+    let k = 3;
+    output[0] = f(1, k, 2);
+    output[1] = g(1, next());
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The argument of the unused parameter of `g` has side effects
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> counter : i32;
+
+fn next() -> i32 {
+  counter += 1;
+  return counter;
+}
+
+fn f(a : i32, b : i32) -> i32 {
+  return (a + b);
+}
+
+fn g(a : i32, unused : i32) -> i32 {
+  return a;
+}
+
+@group(0) @binding(0) var<storage, read_write> output : array<i32, 2>;
+
+@compute @workgroup_size(1)
+fn main() {
+  output[0] = f(1, 2);
+  output[1] = g(1, next());
+}
+)"
+    );
+}
+
+TEST(minifier, RemoveUselessReleasesOnce) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = Minify(
+        R"(
+var<private> o: i32;
+
+fn f(a: i32, b: i32) -> i32 {
+    return a;
+}
+
+@compute @workgroup_size(1) fn main() {
+    let m = o;
+    let k = f(1, m);
+    o = m;
+    o += f(2, 3);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The read of `m` in the removed argument is also in the removed `k`, and only counts once
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> o : i32;
+
+fn f(a : i32) -> i32 {
+  return a;
+}
+
+@compute @workgroup_size(1)
+fn main() {
+  let m = o;
+  o = m;
+  o += f(2);
+}
+)"
+    );
+}
+
+TEST(minifier, PruneStructMembers) {
+    auto options = NoPasses();
+    options.prune_struct_members = true;
+    auto result = Minify(
+        R"(
+struct Local {
+    a: f32,
+    b: f32,
+    c: vec3f,
+}
+
+struct Shared {
+    a: f32,
+    b: f32,
+}
+
+@group(0) @binding(0) var<uniform> globals: Shared;
+
+fn make(x: f32) -> Local {
+    return Local(x, x * 2.0, vec3f(x));
+}
+
+@fragment fn main() -> @location(0) vec4f {
+    let l = make(globals.a);
+    return vec4f(l.c, 1.0);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The layout of `Shared` is shared with the host
+    EXPECT_EQ(
+        Write(result.program),
+        R"(struct Local {
+  c : vec3f,
+}
+
+struct Shared {
+  a : f32,
+  b : f32,
+}
+
+@group(0) @binding(0) var<uniform> globals : Shared;
+
+fn make(x : f32) -> Local {
+  return Local(vec3f(x));
+}
+
+@fragment
+fn main() -> @location(0) vec4f {
+  let l = make(globals.a);
+  return vec4f(l.c, 1.0);
+}
+)"
+    );
+}
+
+TEST(minifier, MinifyEntryPoints) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    auto result = MinifyEntryPoints(
+        R"(
+const scale = 2.0;
+const offset = 1.0;
+
+fn helper(x: f32) -> f32 {
+    return x * scale;
+}
+
+@vertex fn vs() -> @builtin(position) vec4f {
+    return vec4f(helper(1.0));
+}
+
+@fragment fn fs() -> @location(0) vec4f {
+    return vec4f(helper(offset));
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    ASSERT_EQ(result.entry_points.size(), 2u);
+
+    EXPECT_EQ(result.entry_points[0].entry_point, "vs");
+    EXPECT_EQ(
+        Write(result.entry_points[0].result.program),
+        R"(const scale = 2.0;
+
+fn helper(x : f32) -> f32 {
+  return (x * scale);
+}
+
+@vertex
+fn vs() -> @builtin(position) vec4f {
+  return vec4f(helper(1.0));
+}
+)"
+    );
+
+    EXPECT_EQ(result.entry_points[1].entry_point, "fs");
+    EXPECT_EQ(
+        Write(result.entry_points[1].result.program),
+        R"(const scale = 2.0;
+
+const offset = 1.0;
+
+fn helper(x : f32) -> f32 {
+  return (x * scale);
+}
+
+@fragment
+fn fs() -> @location(0) vec4f {
+  return vec4f(helper(offset));
+}
+)"
+    );
+}
+
+TEST(minifier, UnknownEntryPoint) {
+    constexpr auto code = R"(
+@vertex fn vs() -> @builtin(position) vec4f {
+    return vec4f();
+}
+)";
+    auto result = Minify(code, {.entry_points = {"vs", "fs"}});
+    EXPECT_TRUE(result.failed);
+    EXPECT_EQ(result.failure_message, "unknown entry point 'fs'");
+
+    auto split = MinifyEntryPoints(code, {.entry_points = {"main"}});
+    EXPECT_TRUE(split.failed);
+    EXPECT_EQ(split.failure_message, "unknown entry point 'main'");
+    EXPECT_TRUE(split.entry_points.empty());
+}
+
+TEST(minifier, KeepEntryPoints) {
+    auto options = NoPasses();
+    options.entry_points = {"fs", "cs"};
+    auto result = Minify(
+        R"(
+var<private> a: f32;
+var<private> b: f32;
+
+fn fa() -> f32 {
+    return a;
+}
+
+@vertex fn vs() -> @builtin(position) vec4f {
+    return vec4f(fa());
+}
+
+@fragment fn fs() -> @location(0) vec4f {
+    return vec4f(b);
+}
+
+@compute @workgroup_size(1) fn cs() {
+    b = 1.0;
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> b : f32;
+
+@fragment
+fn fs() -> @location(0) vec4f {
+  return vec4f(b);
+}
+
+@compute @workgroup_size(1)
+fn cs() {
+  b = 1.0;
+}
+)"
+    );
+}
+
+TEST(minifier, RemovePureCalls) {
+    auto options = NoPasses();
+    options.remove_useless = true;
+    options.remove_pure_calls = true;
+    auto result = Minify(
+        R"(
+var<private> counter: i32;
+@group(0) @binding(0) var<storage, read_write> output: array<f32, 4>;
+
+fn square(x: f32) -> f32 {
+    var y = x;
+    y *= x;
+    return y;
+}
+
+fn twice(x: f32) -> f32 {
+    return square(x) + square(x);
+}
+
+fn count() -> i32 {
+    counter += 1;
+    return counter;
+}
+
+fn store(p: ptr<function, f32>) {
+    *p = 1.0;
+}
+
+fn write(x: f32) -> f32 {
+    output[0] = x;
+    return x;
+}
+
+@compute @workgroup_size(1) fn main() {
+    var v = 2.0;
+    _ = twice(v);
+    _ = count();
+    store(&v);
+    _ = write(v);
+    let unused = square(3.0);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `square` is only unreached once `unused` is removed
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> counter : i32;
+
+@group(0) @binding(0) var<storage, read_write> output : array<f32, 4>;
+
+fn count() -> i32 {
+  counter += 1;
+  return counter;
+}
+
+fn store(p : ptr<function, f32>) {
+  *(p) = 1.0;
+}
+
+fn write(x : f32) -> f32 {
+  output[0] = x;
+  return x;
+}
+
+@compute @workgroup_size(1)
+fn main() {
+  var v = 2.0;
+  _ = count();
+  store(&(v));
+  _ = write(v);
+}
+)"
+    );
+}
+
+TEST(minifier, SubstituteOverrides) {
+    auto options = NoPasses();
+    options.overrides = {{"3", 1}, {"shadows", 1}};
+    auto result = Minify(
+        R"(
+@id(3) override quality: i32 = 1;
+override shadows: bool;
+override scale: f32 = 1.0;
+
+fn shade(x: f32) -> f32 {
+    return x * 0.5;
+}
+
+fn shadow(x: f32) -> f32 {
+    return x * 0.25;
+}
+
+@fragment fn fs() -> @location(0) vec4f {
+    var color = 1.0;
+    if (quality > 2) {
+        color = shade(color);
+    } else if (shadows) {
+        color = shadow(color);
+    }
+    return vec4f(color * scale);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `quality` is found by its @id. The branches are folded by the later passes.
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const quality = 1i;
+
+const shadows = true;
+
+override scale : f32 = 1.0;
+
+fn shade(x : f32) -> f32 {
+  return (x * 0.5);
+}
+
+fn shadow(x : f32) -> f32 {
+  return (x * 0.25);
+}
+
+@fragment
+fn fs() -> @location(0) vec4f {
+  var color = 1.0;
+  if ((quality > 2)) {
+    color = shade(color);
+  } else if (shadows) {
+    color = shadow(color);
+  }
+  return vec4f((color * scale));
+}
+)"
+    );
+}
+
+TEST(minifier, SubstituteOverridesLowestI32) {
+    auto options = NoPasses();
+    options.overrides = {{"lowest", -2147483648.0}};
+    auto result = Minify(
+        R"(
+override lowest: i32;
+
+@compute @workgroup_size(1) fn main() {
+    _ = lowest;
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const lowest = i32((-2147483647i - 1i));
+
+@compute @workgroup_size(1)
+fn main() {
+  _ = lowest;
+}
+)"
+    );
+}
+
+TEST(minifier, SubstituteOverridesOutOfRange) {
+    static constexpr auto Source = R"(
+override count: u32;
+override scale: i32;
+
+@compute @workgroup_size(1) fn main() {
+    _ = count;
+    _ = scale;
+}
+)";
+    auto options = NoPasses();
+    options.overrides = {{"count", -1}};
+    auto result = Minify(Source, options);
+    EXPECT_TRUE(result.failed);
+    EXPECT_EQ(result.failure_message, "value -1 of override 'count' isn't representable as u32");
+
+    options.overrides = {{"scale", 1.5}};
+    auto fraction = Minify(Source, options);
+    EXPECT_TRUE(fraction.failed);
+    EXPECT_EQ(fraction.failure_message, "value 1.5 of override 'scale' isn't representable as i32");
+}
+
+TEST(minifier, PromoteVariables) {
+    auto options = NoPasses();
+    options.promote_variables = true;
+    auto result = Minify(
+        R"(
+var<private> table: array<f32, 3> = array(1.0, 2.0, 4.0);
+var<private> enabled: bool = false;
+var<private> written = 1.0;
+
+fn update(p: ptr<function, f32>) {
+    *p = 2.0;
+}
+
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    var scale = 2;
+    var offset = uv.x;
+    var pointed = 1.0;
+    update(&pointed);
+    written = offset;
+    if (enabled) {
+        return vec4f(0.0);
+    }
+    return vec4f(table[i32(uv.y)] * f32(scale) + offset + pointed + written);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `written` is stored to and the address of `pointed` is taken
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const table : array<f32, 3> = array(1.0, 2.0, 4.0);
+
+const enabled : bool = false;
+
+var<private> written = 1.0;
+
+fn update(p : ptr<function, f32>) {
+  *(p) = 2.0;
+}
+
+@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  const scale : i32 = 2;
+  let offset = uv.x;
+  var pointed = 1.0;
+  update(&(pointed));
+  written = offset;
+  if (enabled) {
+    return vec4f(0.0);
+  }
+  return vec4f(((((table[i32(uv.y)] * f32(scale)) + offset) + pointed) + written));
+}
+)"
+    );
+}
+
+TEST(minifier, PromoteVariablesKeepsValidity) {
+    auto options = NoPasses();
+    options.promote_variables = true;
+    auto result = Minify(
+        R"(
+@group(0) @binding(0) var<storage, read_write> output: array<i32, 4>;
+
+@compute @workgroup_size(1) fn main() {
+    var i = 5;
+    var z = 0;
+    var s = 2;
+    output[i] = output[0] / z;
+    output[1] = output[2] * s;
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // As consts, `i` would be an out of bounds index and `z` a division by zero
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@group(0) @binding(0) var<storage, read_write> output : array<i32, 4>;
+
+@compute @workgroup_size(1)
+fn main() {
+  let i = 5;
+  let z = 0;
+  const s : i32 = 2;
+  output[i] = (output[0] / z);
+  output[1] = (output[2] * s);
+}
+)"
+    );
+}
+
+TEST(minifier, PromoteSingleAssignment) {
+    auto options = NoPasses();
+    options.promote_variables = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    let half = 0.5;
+    var a: f32;
+    a = uv.x * half;
+    var b: f32;
+    if (uv.y > 0.0) {
+        b = 1.0;
+    }
+    var c: f32;
+    let d = c;
+    c = 2.0;
+    return vec4f(a, b, c, d);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `b` is assigned in a nested block, and `c` is read before its assignment
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  const half : f32 = 0.5;
+  let a : f32 = (uv.x * half);
+  var b : f32;
+  if ((uv.y > 0.0)) {
+    b = 1.0;
+  }
+  var c : f32;
+  let d = c;
+  c = 2.0;
+  return vec4f(a, b, c, d);
+}
+)"
+    );
+}
+
+TEST(minifier, PromoteLetsKeepsValidity) {
+    auto options = NoPasses();
+    options.promote_variables = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) x: i32) -> @location(0) vec4f {
+    let a = array<f32, 4>(1.0, 2.0, 3.0, 4.0);
+    let i = 5;
+    let d = 0;
+    let h = 0.5;
+    var b: i32;
+    b = 0;
+    return vec4f(a[i], f32(x % d), f32(x >> u32(b)), h);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Constant `i`, `d` and `b` would make an out of bounds index, a division by zero and a shift by a constant
+    // which are checked. The array is indexed by `i`, so it stays a let with it.
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) x : i32) -> @location(0) vec4f {
+  let a = array<f32, 4>(1.0, 2.0, 3.0, 4.0);
+  let i = 5;
+  let d = 0;
+  const h : f32 = 0.5;
+  let b : i32 = 0;
+  return vec4f(a[i], f32((x % d)), f32((x >> u32(b))), h);
+}
+)"
+    );
+}
+
+TEST(minifier, InlineConstants) {
+    auto options = NoPasses();
+    options.inline_constants = true;
+    auto result = Minify(
+        R"(
+const eps = 0.0625;
+const scale = 1.234375;
+
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    var values: array<f32, 4>;
+    values[0] = uv.x + eps;
+    return vec4f(scale, scale * 2.0, scale * 0.5, scale * values[0]);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Four copies of `scale` would be longer than its declaration and references
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const scale = 1.234375;
+
+@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  var values : array<f32, 4>;
+  values[0] = (uv.x + 0.0625);
+  return vec4f(scale, (scale * 2.0), (scale * 0.5), (scale * values[0]));
+}
+)"
+    );
+}
+
+TEST(minifier, InlineFunctions) {
+    auto options = NoPasses();
+    options.inline_functions = true;
+    auto result = Minify(
+        R"(
+@group(0) @binding(0) var<storage, read_write> output: array<f32>;
+
+fn square(x: f32) -> f32 {
+    return x * x;
+}
+
+fn clamp_index(i: u32) -> u32 {
+    if (i >= arrayLength(&output)) {
+        return 0;
+    }
+    return i;
+}
+
+fn accumulate(p: ptr<function, f32>, x: f32) {
+    *p += x;
+}
+
+@compute @workgroup_size(1) fn main(@builtin(global_invocation_id) id: vec3u) {
+    let x = 2.0;
+    var sum = square(f32(id.x));
+    let y = square(x);
+    accumulate(&sum, y);
+    output[clamp_index(id.x)] = sum;
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `clamp_index` is only called as an index, which isn't a supported call site. Names are passed through.
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@group(0) @binding(0) var<storage, read_write> output : array<f32>;
+
+fn square(x : f32) -> f32 {
+  return (x * x);
+}
+
+fn clamp_index(i : u32) -> u32 {
+  if ((i >= arrayLength(&(output)))) {
+    return 0;
+  }
+  return i;
+}
+
+fn accumulate(p : ptr<function, f32>, x : f32) {
+  *(p) += x;
+}
+
+@compute @workgroup_size(1)
+fn main(@builtin(global_invocation_id) id : vec3u) {
+  let x = 2.0;
+  let x_1 : f32 = f32(id.x);
+  var sum = (x_1 * x_1);
+  let y = (x * x);
+  let p_1 : ptr<function, f32> = &(sum);
+  *(p_1) += y;
+  output[clamp_index(id.x)] = sum;
+}
+)"
+    );
+}
+
+TEST(minifier, InlineFunctionsReturningEarly) {
+    auto options = NoPasses();
+    options.inline_functions = true;
+    auto result = Minify(
+        R"(
+var<private> total: f32;
+
+fn clamp_to_zero(x: f32) -> f32 {
+    if (x < 0.0) {
+        return 0.0;
+    }
+    return x;
+}
+
+fn accumulate(x: f32) -> f32 {
+    if (x < 0.0) {
+        return total;
+    }
+    total += x;
+    return total;
+}
+
+@fragment fn fs(@location(0) v: f32) -> @location(0) vec4f {
+    let y = clamp_to_zero(v);
+    accumulate(y);
+    return vec4f(y, total, 0.0, 1.0);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The value of `accumulate` is unused, so its returns only evaluate it
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> total : f32;
+
+fn clamp_to_zero(x : f32) -> f32 {
+  if ((x < 0.0)) {
+    return 0.0;
+  }
+  return x;
+}
+
+fn accumulate(x : f32) -> f32 {
+  if ((x < 0.0)) {
+    return total;
+  }
+  total += x;
+  return total;
+}
+
+@fragment
+fn fs(@location(0) v : f32) -> @location(0) vec4f {
+  var result : f32;
+  loop {
+    if ((v < 0.0)) {
+      {
+        result = 0.0;
+        break;
+      }
+    }
+    {
+      result = v;
+      break;
+    }
+  }
+  let y = result;
+  loop {
+    if ((y < 0.0)) {
+      {
+        _ = total;
+        break;
+      }
+    }
+    total += y;
+    {
+      _ = total;
+      break;
+    }
+  }
+  return vec4f(y, total, 0.0, 1.0);
+}
+)"
+    );
+}
+
+TEST(minifier, InlineFunctionsPassesHandles) {
+    auto options = NoPasses();
+    options.inline_functions = true;
+    auto result = Minify(
+        R"(
+@group(0) @binding(0) var t: texture_2d<f32>;
+
+fn fetch(tex: texture_2d<f32>, i: i32) -> vec4f {
+    return textureLoad(tex, vec2i(i, 0), 0);
+}
+
+@fragment fn fs(@builtin(position) position: vec4f) -> @location(0) vec4f {
+    return fetch(t, i32(position.x));
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // A texture can't be bound to a let
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@group(0) @binding(0) var t : texture_2d<f32>;
+
+fn fetch(tex : texture_2d<f32>, i : i32) -> vec4f {
+  return textureLoad(tex, vec2i(i, 0), 0);
+}
+
+@fragment
+fn fs(@builtin(position) position : vec4f) -> @location(0) vec4f {
+  let i_1 : i32 = i32(position.x);
+  return textureLoad(t, vec2i(i_1, 0), 0);
+}
+)"
+    );
+}
+
+TEST(minifier, InlineFunctionsBindsConstants) {
+    auto options = NoPasses();
+    options.inline_functions = true;
+    auto result = Minify(
+        R"(
+var<private> table: array<f32, 4>;
+
+fn get(i: i32) -> f32 {
+    return table[i];
+}
+
+fn ratio(x: i32, d: i32) -> i32 {
+    return x / d;
+}
+
+@compute @workgroup_size(1) fn main(@builtin(local_invocation_index) index: u32) {
+    let x = i32(index);
+    let a = get(7);
+    let b = ratio(x, 0);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Substituted, the constants would make an out of bounds index and a division by zero
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> table : array<f32, 4>;
+
+fn get(i : i32) -> f32 {
+  return table[i];
+}
+
+fn ratio(x : i32, d : i32) -> i32 {
+  return (x / d);
+}
+
+@compute @workgroup_size(1)
+fn main(@builtin(local_invocation_index) index : u32) {
+  let x = i32(index);
+  let i_1 : i32 = 7;
+  let a = table[i_1];
+  let d_1 : i32 = 0;
+  let b = (x / d_1);
+}
+)"
+    );
+}
+
+TEST(minifier, InlineLets) {
+    auto options = NoPasses();
+    options.inline_lets = true;
+    auto result = Minify(
+        R"(
+@group(0) @binding(0) var<storage, read_write> output: array<f32, 4>;
+
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    let t1 = uv.x * uv.y;
+    let t2 = t1 + uv.x;
+    let read = output[0];
+    output[0] = 1.0;
+    let twice = uv.y * 2.0;
+    let cond = uv.x > 0.5;
+    if (uv.y > 0.5 && cond) {
+        return vec4f(read);
+    }
+    return vec4f(t2, read, twice, twice);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // A store happens before the use of `t2`, and `cond` would only be evaluated depending on the left of the &&
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@group(0) @binding(0) var<storage, read_write> output : array<f32, 4>;
+
+@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  let t2 = ((uv.x * uv.y) + uv.x);
+  let read = output[0];
+  output[0] = 1.0;
+  let twice = (uv.y * 2.0);
+  let cond = (uv.x > 0.5);
+  if (((uv.y > 0.5) && cond)) {
+    return vec4f(read);
+  }
+  return vec4f(t2, read, twice, twice);
+}
+)"
+    );
+}
+
+TEST(minifier, InlineLetsKeepsShadowed) {
+    auto options = NoPasses();
+    options.inline_lets = true;
+    auto result = Minify(
+        R"(
+var<private> x: f32;
+var<private> y: f32;
+
+@fragment fn fs() -> @location(0) vec4f {
+    let t = x;
+    let x = 2.0;
+    let a = y;
+    let b = a;
+    let y = 3.0;
+    return vec4f(t, x, b, y);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `a` is inlined into `b`, which then refers to the shadowed `y` too
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> x : f32;
+
+var<private> y : f32;
+
+@fragment
+fn fs() -> @location(0) vec4f {
+  let t = x;
+  let x = 2.0;
+  let b = y;
+  let y = 3.0;
+  return vec4f(t, x, b, y);
+}
+)"
+    );
+}
+
+TEST(minifier, HoistCommonSubexpressions) {
+    auto options = NoPasses();
+    options.hoist_common_subexpressions = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) n: vec3f, @location(1) l: vec3f) -> @location(0) vec4f {
+    let diffuse = max(dot(normalize(n), normalize(l)), 0.0);
+    let rim = 1.0 - dot(normalize(n), vec3f(0.0, 0.0, 1.0));
+    if (dpdx(n.x) > 0.0) {
+        return vec4f(dpdx(n.x));
+    }
+    return vec4f(normalize(n) * diffuse * rim, 1.0);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Derivatives depend on uniformity
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) n : vec3f, @location(1) l : vec3f) -> @location(0) vec4f {
+  let common = normalize(n);
+  let diffuse = max(dot(common, normalize(l)), 0.0);
+  let rim = (1.0 - dot(common, vec3f(0.0, 0.0, 1.0)));
+  if ((dpdx(n.x) > 0.0)) {
+    return vec4f(dpdx(n.x));
+  }
+  return vec4f(((common * diffuse) * rim), 1.0);
+}
+)"
+    );
+}
+
+TEST(minifier, SimplifyAlgebra) {
+    auto options = NoPasses();
+    options.simplify_algebra = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f, @location(1) @interpolate(flat) i: i32) -> @location(0) vec4f {
+    let a = uv.x * 1.0;
+    let b = uv.y + 0.0;
+    let c = uv.y - 0.0;
+    let d = i * 0;
+    let e = -(-uv.x);
+    let f = select(uv * 1.0, uv, i > 0);
+    let g = !!(i > 1);
+    let h = uv.x * 0.0;
+    return vec4f(a, b, c + f32(d) + e + h, f.x + f32(g));
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // -0.0 + 0.0 is 0.0, and NaN * 0.0 is NaN
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f, @location(1) @interpolate(flat) i : i32) -> @location(0) vec4f {
+  let a = uv.x;
+  let b = (uv.y + 0.0);
+  let c = uv.y;
+  let d = i32();
+  let e = uv.x;
+  let f = uv;
+  let g = (i > 1);
+  let h = (uv.x * 0.0);
+  return vec4f(a, b, (((c + f32(d)) + e) + h), (f.x + f32(g)));
+}
+)"
+    );
+}
+
+TEST(minifier, RemoveIdentityConversions) {
+    auto options = NoPasses();
+    options.remove_identity_conversions = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f, @location(1) @interpolate(flat) i: u32) -> @location(0) vec4f {
+    var v = vec4f(uv, 0.0, 1.0);
+    let a = f32(uv.x);
+    let b = vec4f(v);
+    let c = f32(i);
+    let d = vec2f(vec2f(uv));
+    let e = f32(1);
+    return vec4f(a + c + e, b.y, d);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // `f32(1)` materializes an abstract integer
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f, @location(1) @interpolate(flat) i : u32) -> @location(0) vec4f {
+  var v = vec4f(uv, 0.0, 1.0);
+  let a = uv.x;
+  let b = v;
+  let c = f32(i);
+  let d = uv;
+  let e = f32(1);
+  return vec4f(((a + c) + e), b.y, d);
+}
+)"
+    );
+}
+
+TEST(minifier, ElideDeclarationTypes) {
+    auto options = NoPasses();
+    options.elide_declaration_types = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    let a: f32 = uv.x;
+    var b: f32 = 1.0;
+    var c: u32 = 1u;
+    let d: vec2<f32> = vec2(1.0, 2.0) * uv;
+    var e: f32 = 1;
+    b += a;
+    c += 1u;
+    e += a;
+    return vec4f(d, b + f32(c), e);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The writer drops the suffix of `1u`, which would make `c` an i32
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  let a = uv.x;
+  var b = 1.0;
+  var c : u32 = 1u;
+  let d = (vec2(1.0, 2.0) * uv);
+  var e : f32 = 1;
+  b += a;
+  c += 1u;
+  e += a;
+  return vec4f(d, (b + f32(c)), e);
+}
+)"
+    );
+}
+
+TEST(minifier, ElideDeclarationTypesOfConstUsers) {
+    auto options = NoPasses();
+    options.elide_declaration_types = true;
+    auto result = Minify(
+        R"(
+const c = 1u;
+const d = c;
+const e = 2;
+
+@compute @workgroup_size(1) fn main() {
+    let x: u32 = d;
+    let y: i32 = e;
+    _ = x + u32(y);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Without suffixes `c` and `d` are abstract, which would make `x` an i32
+    EXPECT_EQ(
+        Write(result.program),
+        R"(const c = 1u;
+
+const d = c;
+
+const e = 2;
+
+@compute @workgroup_size(1)
+fn main() {
+  let x : u32 = d;
+  let y = e;
+  _ = (x + u32(y));
+}
+)"
+    );
+}
+
+TEST(minifier, ShortenConstructors) {
+    auto options = NoPasses();
+    options.shorten_constructors = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    let a = vec4f(1.0, 1.0, 1.0, 1.0) * uv.x;
+    let b = vec2(2.0, 2.0) * uv;
+    let m = mat2x2f(0.0, 0.0, 0.0, 0.0) + mat2x2f(uv, uv);
+    let c = vec2f(-0.0, 0.0) + uv;
+    return a + vec4f(vec3f(0.0, 0.0, 0.0) + b.x, m[0].x + c.x);
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The zero value is positive
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  let a = (vec4f(1.0) * uv.x);
+  let b = (vec2(2.0) * uv);
+  let m = (mat2x2f() + mat2x2f(uv, uv));
+  let c = (vec2f(-(0.0), 0.0) + uv);
+  return (a + vec4f((vec3f() + b.x), (m[0].x + c.x)));
+}
+)"
+    );
+}
+
+TEST(minifier, CanonicalizeSwizzles) {
+    auto options = NoPasses();
+    options.canonicalize_swizzles = true;
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) v: vec4f, @location(1) a: vec2f) -> @location(0) vec4f {
+    let p = v.xyzw;
+    let q = vec3f(v.x, v.y, v.z);
+    let r = vec2f(a.x, a.y);
+    let s = vec2f(v.x, a.y);
+    return p * v.rgba.x + vec4f(q, 1.0) + r.xyxy + s.xxyy;
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Swizzles of different vectors are kept
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) v : vec4f, @location(1) a : vec2f) -> @location(0) vec4f {
+  let p = v;
+  let q = v.xyz;
+  let r = a;
+  let s = vec2f(v.x, a.y);
+  return ((((p * v.x) + vec4f(q, 1.0)) + r.xyxy) + s.xxyy);
+}
+)"
+    );
+}
+
+TEST(minifier, ShortenAssignments) {
+    auto options = NoPasses();
+    options.shorten_assignments = true;
+    auto result = Minify(
+        R"(
+var<private> a: vec2f;
+var<private> m: mat2x2f;
+
+fn next() -> i32 {
+    a.y += 1.0;
+    return 1;
+}
+
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    var s = 0.0;
+    var k = 0;
+    for (var i = 0; i < 4; i = i + 1) {
+        s = s + uv.x;
+        a.x = a.x * 2.0;
+        a = uv * a;
+        m = uv.x * m;
+        k += 1;
+        k = next() + k;
+    }
+    a = m * a;
+    return vec4f(s, a, f32(k));
+}
+)",
+        options
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // The call may store to the target, and the product of matrices doesn't commute
+    EXPECT_EQ(
+        Write(result.program),
+        R"(var<private> a : vec2f;
+
+var<private> m : mat2x2f;
+
+fn next() -> i32 {
+  a.y += 1.0;
+  return 1;
+}
+
+@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  var s = 0.0;
+  var k = 0;
+  for(var i = 0; (i < 4); i++) {
+    s += uv.x;
+    a.x *= 2.0;
+    a *= uv;
+    m *= uv.x;
+    k++;
+    k = (next() + k);
+  }
+  a = (m * a);
+  return vec4f(s, a, f32(k));
+}
+)"
+    );
+}
+
+TEST(minifier, DisableSinglePass) {
+    auto result = Minify(
+        R"(
+@fragment fn fs(@location(0) uv: vec2f) -> @location(0) vec4f {
+    let t = uv.x * uv.y;
+    let unused = uv.y;
+    return vec4f(t);
+}
+)",
+        {
+            .rename_identifiers = false,
+            .remove_unreachable_statements = false,
+            .inline_lets = false,
+        }
+    );
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    // Unused declarations are still removed
+    EXPECT_EQ(
+        Write(result.program),
+        R"(@fragment
+fn fs(@location(0) uv : vec2f) -> @location(0) vec4f {
+  let t = (uv.x * uv.y);
+  return vec4f(t);
+}
+)"
+    );
+}
+
 }  // namespace wgslx::minifier
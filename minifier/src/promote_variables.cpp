@@ -0,0 +1,398 @@
+#include "promote_variables.h"
+
+#include <src/tint/lang/core/address_space.h>
+#include <src/tint/lang/core/binary_op.h>
+#include <src/tint/lang/core/evaluation_stage.h>
+#include <src/tint/lang/core/type/bool.h>
+#include <src/tint/lang/core/type/f16.h>
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/let.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/phony_expression.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/builtin_fn.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/function.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_constructor.h>
+#include <src/tint/lang/wgsl/sem/value_conversion.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "evaluation.h"
+#include "stores.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::PromoteVariables);
+
+namespace wgslx::minifier {
+
+struct Mutation {
+    std::size_t stores = 0;
+    // The store, if it assigns the whole variable
+    const tint::ast::AssignmentStatement* assign = nullptr;
+    bool address_taken = false;
+};
+
+// Stores to variables and taken addresses, directly or through a member or element
+static std::unordered_map<const tint::sem::Variable*, Mutation> FindMutations(const tint::Program& program) {
+    std::unordered_map<const tint::sem::Variable*, Mutation> mutations;
+    auto find = [&](const tint::ast::Expression* expr) -> Mutation* {
+        const auto* ident = StoreRoot(expr)->As<tint::ast::IdentifierExpression>();
+        const auto* user = ident ? program.Sem().Get<tint::sem::VariableUser>(ident) : nullptr;
+        return user ? &mutations[user->Variable()] : nullptr;
+    };
+
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::Node>(function->body, [&](const tint::ast::Node* node) {
+            if (const auto* unary = node->As<tint::ast::UnaryOpExpression>()) {
+                auto* mutation = unary->op == tint::core::UnaryOp::kAddressOf ? find(unary->expr) : nullptr;
+                if (mutation) {
+                    mutation->address_taken = true;
+                }
+                return;
+            }
+            const auto* stmt = node->As<tint::ast::Statement>();
+            const auto* target = stmt ? StoreTarget(stmt) : nullptr;
+            auto* mutation = target && !target->Is<tint::ast::PhonyExpression>() ? find(target) : nullptr;
+            if (mutation) {
+                ++mutation->stores;
+                const auto* assign = stmt->As<tint::ast::AssignmentStatement>();
+                mutation->assign = assign && assign->lhs->Is<tint::ast::IdentifierExpression>() ? assign : nullptr;
+            }
+        });
+    }
+    return mutations;
+}
+
+// Calls `callback` with the operands of `expr`, the expressions it evaluates directly
+template<typename F>
+static void ForEachOperand(const tint::ast::Expression* expr, F&& callback) {
+    tint::Switch(
+        expr,
+        [&](const tint::ast::IndexAccessorExpression* index) {
+            callback(index->object);
+            callback(index->index);
+        },
+        [&](const tint::ast::MemberAccessorExpression* member) { callback(member->object); },
+        [&](const tint::ast::BinaryExpression* binary) {
+            callback(binary->lhs);
+            callback(binary->rhs);
+        },
+        [&](const tint::ast::UnaryOpExpression* unary) { callback(unary->expr); },
+        [&](const tint::ast::CallExpression* call) {
+            for (const auto* arg : call->args) {
+                callback(arg);
+            }
+        },
+        [&](tint::Default) {}
+    );
+}
+
+// The expression directly containing each expression of a function body
+static std::unordered_map<const tint::ast::Expression*, const tint::ast::Expression*> FindParents(
+    const tint::Program& program
+) {
+    std::unordered_map<const tint::ast::Expression*, const tint::ast::Expression*> parents;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::Expression>(function->body, [&](const tint::ast::Expression* expr) {
+            ForEachOperand(expr, [&](const tint::ast::Expression* operand) { parents.emplace(operand, expr); });
+        });
+    }
+    return parents;
+}
+
+class Promoter {
+ public:
+    using CreateType = std::function<tint::ast::Type(const tint::core::type::Type*)>;
+
+    Promoter(
+        tint::program::CloneContext* ctx,
+        std::unordered_map<const tint::sem::Variable*, Mutation>&& mutations,
+        CreateType&& create_type
+    )
+        : ctx_(ctx),
+          mutations_(std::move(mutations)),
+          parents_(FindParents(*ctx->src)),
+          create_type_(std::move(create_type)) {}
+
+    bool Run() {
+        for (const auto* node : ctx_->src->AST().GlobalDeclarations()) {
+            TraverseNodes<tint::ast::Variable>(node, [&](const tint::ast::Variable* variable) {
+                const auto* sem = ctx_->src->Sem().Get(variable);
+                if (!sem) {
+                    return;
+                }
+                if (const auto* var = variable->As<tint::ast::Var>()) {
+                    PromoteVar(var, sem);
+                } else if (const auto* let = variable->As<tint::ast::Let>()) {
+                    PromoteLet(let, sem);
+                }
+            });
+        }
+        return promoted_;
+    }
+
+ private:
+    tint::program::CloneContext* ctx_;
+    std::unordered_map<const tint::sem::Variable*, Mutation> mutations_;
+    std::unordered_map<const tint::ast::Expression*, const tint::ast::Expression*> parents_;
+    CreateType create_type_;
+    bool promoted_ = false;
+
+    [[nodiscard]] const Mutation* FindMutation(const tint::sem::Variable* sem) const {
+        auto iter = mutations_.find(sem);
+        return iter != mutations_.end() ? &iter->second : nullptr;
+    }
+
+    // Never written variables with an initializer become values in place
+    void PromoteVar(const tint::ast::Var* var, const tint::sem::Variable* sem) {
+        const auto* mutation = FindMutation(sem);
+        if (mutation && mutation->address_taken) {
+            return;
+        }
+        auto global = sem->Is<tint::sem::GlobalVariable>();
+        auto space = sem->AddressSpace();
+        if (global ? space != tint::core::AddressSpace::kPrivate : space != tint::core::AddressSpace::kFunction) {
+            return;
+        }
+
+        if (!mutation && var->initializer) {
+            auto constant = IsConstant(var->initializer) && IsConstantSafe(sem);
+            if (!global || constant) {
+                ctx_->Replace(var, Promote(var, var->initializer, constant));
+                promoted_ = true;
+            }
+        } else if (mutation && !global && !var->initializer && mutation->stores == 1 && mutation->assign) {
+            PromoteAssigned(var, sem, mutation->assign);
+        }
+    }
+
+    // `var x: T; ...; x = e;` becomes `let x: T = e;` if the assignment is in the same block as the declaration
+    // and x isn't used before it
+    void PromoteAssigned(
+        const tint::ast::Var* var,
+        const tint::sem::Variable* sem,
+        const tint::ast::AssignmentStatement* assign
+    ) {
+        const auto* parent = ctx_->src->Sem().Get(assign)->Parent();
+        const auto* block = parent ? parent->Declaration()->As<tint::ast::BlockStatement>() : nullptr;
+        if (!block) {
+            return;
+        }
+
+        std::unordered_map<const tint::ast::Statement*, std::size_t> positions;
+        const tint::ast::VariableDeclStatement* declaration = nullptr;
+        for (std::size_t i = 0; i < block->statements.Length(); ++i) {
+            const auto* stmt = block->statements[i];
+            positions.emplace(stmt, i);
+            if (const auto* d = stmt->As<tint::ast::VariableDeclStatement>(); d && d->variable == var) {
+                declaration = d;
+            }
+        }
+        if (!declaration) {
+            return;
+        }
+
+        auto assigned_at = positions[assign];
+        for (const auto* user : sem->Users()) {
+            if (user->Declaration() == assign->lhs) {
+                continue;
+            }
+            const auto* stmt = EnclosingStatement(user->Stmt(), block);
+            if (!stmt || positions[stmt] <= assigned_at) {
+                return;
+            }
+        }
+
+        ctx_->Remove(block->statements, declaration);
+        auto constant = IsConstant(assign->rhs) && IsConstantSafe(sem);
+        ctx_->Replace(assign, ctx_->dst->Decl(Promote(var, assign->rhs, constant)));
+        promoted_ = true;
+    }
+
+    // A let with a const-expression initializer becomes a const, if its uses stay valid
+    void PromoteLet(const tint::ast::Let* let, const tint::sem::Variable* sem) {
+        if (!sem->Initializer() || !IsConstant(let->initializer) || !IsConstantSafe(sem)) {
+            return;
+        }
+        ctx_->Replace(let, Promote(let, let->initializer, true));
+        promoted_ = true;
+    }
+
+    [[nodiscard]] bool IsConstant(const tint::ast::Expression* expr) const {
+        const auto* sem = ctx_->src->Sem().GetVal(expr);
+        return sem && sem->Stage() == tint::core::EvaluationStage::kConstant;
+    }
+
+    // An identifier of a variable which may become a const, as its initializer is a const-expression or it may be
+    // declared at a single assignment of one
+    [[nodiscard]] bool IsCandidate(const tint::ast::Expression* expr) const {
+        const auto* ident = expr->As<tint::ast::IdentifierExpression>();
+        const auto* user = ident ? ctx_->src->Sem().Get<tint::sem::VariableUser>(ident) : nullptr;
+        const auto* variable = user ? user->Variable() : nullptr;
+        const auto* decl = variable ? variable->Declaration() : nullptr;
+        if (decl && decl->Is<tint::ast::Let>()) {
+            return IsConstant(decl->initializer);
+        }
+        if (!decl || !decl->Is<tint::ast::Var>()) {
+            return false;
+        }
+        auto space = variable->AddressSpace();
+        if (decl->initializer) {
+            return (space == tint::core::AddressSpace::kFunction || space == tint::core::AddressSpace::kPrivate) &&
+                   IsConstant(decl->initializer);
+        }
+        return space == tint::core::AddressSpace::kFunction;
+    }
+
+    // Whether `expr` containing `child` becomes a const-expression if `child` does
+    [[nodiscard]] bool BecomesConstant(const tint::ast::Expression* expr, const tint::ast::Expression* child) const {
+        if (expr->Is<tint::ast::CallExpression>()) {
+            const auto* sem = ctx_->src->Sem().GetVal(expr);
+            const auto* call = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+            if (!call || call->Target()->Is<tint::sem::Function>()) {
+                return false;
+            }
+        }
+        auto constant = true;
+        ForEachOperand(expr, [&](const tint::ast::Expression* operand) {
+            constant = constant && (operand == child || IsConstant(operand) || IsCandidate(operand));
+        });
+        return constant;
+    }
+
+    // Whether the constant evaluation of `expr`, whose operands became constant, can't fail where the evaluation at
+    // runtime didn't. Only constructors and conversions which can represent every value are.
+    [[nodiscard]] bool IsInfallible(const tint::ast::Expression* expr) const {
+        if (expr->Is<tint::ast::MemberAccessorExpression>()) {
+            return true;
+        }
+        const auto* sem = expr->Is<tint::ast::CallExpression>() ? ctx_->src->Sem().GetVal(expr) : nullptr;
+        const auto* call = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+        if (!call) {
+            return false;
+        }
+        if (call->Target()->Is<tint::sem::ValueConstructor>()) {
+            return true;
+        }
+        if (const auto* conversion = call->Target()->As<tint::sem::ValueConversion>()) {
+            const auto* from = conversion->Source()->DeepestElement();
+            return (from->IsIntegerScalar() || from->Is<tint::core::type::Bool>()) &&
+                   !conversion->Target()->DeepestElement()->Is<tint::core::type::F16>();
+        }
+        return false;
+    }
+
+    // Whether `child` being a const-expression makes `expr`, which stays a runtime expression, invalid: constant
+    // indices are bounds checked, constant divisors and shift amounts are checked, and builtins check some
+    // constant arguments
+    [[nodiscard]] bool RejectsConstant(const tint::ast::Expression* expr, const tint::ast::Expression* child) const {
+        return tint::Switch(
+            expr,
+            [&](const tint::ast::IndexAccessorExpression* index) { return index->index == child; },
+            [&](const tint::ast::BinaryExpression* binary) {
+                return binary->rhs == child &&
+                       (binary->op == tint::core::BinaryOp::kDivide || binary->op == tint::core::BinaryOp::kModulo ||
+                        binary->op == tint::core::BinaryOp::kShiftLeft ||
+                        binary->op == tint::core::BinaryOp::kShiftRight);
+            },
+            [&](const tint::ast::CallExpression* call) {
+                const auto* sem = ctx_->src->Sem().GetVal(call);
+                const auto* target = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+                return !target || target->Target()->Is<tint::sem::BuiltinFn>();
+            },
+            [&](tint::Default) { return false; }
+        );
+    }
+
+    // Whether every user of `sem` still validates once it is a const, which makes the expressions using it const
+    // evaluated and checked where they weren't
+    [[nodiscard]] bool IsConstantSafe(const tint::sem::Variable* sem) const {
+        for (const auto* user : sem->Users()) {
+            const tint::ast::Expression* expr = user->Declaration();
+            for (auto iter = parents_.find(expr); iter != parents_.end(); iter = parents_.find(expr)) {
+                const auto* parent = iter->second;
+                if (!BecomesConstant(parent, expr)) {
+                    if (RejectsConstant(parent, expr)) {
+                        return false;
+                    }
+                    break;
+                }
+                if (!IsInfallible(parent)) {
+                    return false;
+                }
+                expr = parent;
+            }
+        }
+        return true;
+    }
+
+    // A const if `constant`, which requires `initializer` to be a const-expression, a let otherwise
+    const tint::ast::Variable* Promote(
+        const tint::ast::Variable* variable,
+        const tint::ast::Expression* initializer,
+        bool constant
+    ) {
+        const auto* sem = ctx_->src->Sem().Get(variable);
+
+        // A const keeps an abstract initializer abstract, so it needs the type the variable materialized
+        tint::ast::Type type;
+        if (variable->type) {
+            type = tint::ast::Type {ctx_->Clone(variable->type.expr)};
+        } else if (constant && ctx_->src->Sem().GetVal(initializer)->UnwrapMaterialize()->Type()->IsAbstract()) {
+            type = create_type_(sem->Type()->UnwrapRef());
+        }
+
+        auto source = ctx_->Clone(variable->source);
+        auto name = ctx_->Clone(variable->name->symbol);
+        const auto* value = ctx_->Clone(initializer);
+        if (constant) {
+            return ctx_->dst->Const(source, name, type, value);
+        }
+        return ctx_->dst->Let(source, name, type, value);
+    }
+};
+
+PromoteVariables::ApplyResult PromoteVariables::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+    Promoter promoter(&ctx, FindMutations(program), [&](const tint::core::type::Type* type) {
+        return CreateASTTypeFor(ctx, type);
+    });
+    if (!promoter.Run()) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
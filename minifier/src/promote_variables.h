@@ -0,0 +1,24 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Turns variables into values, so more of the shader can be folded:
+// - `var<private>` and function scope `var`s which are never written and whose address is never taken become a
+//   `const` if the initializer is a const-expression, otherwise a `let` for function scope variables. A const makes
+//   the expressions using it constant, which are checked when the shader is created, so it is only declared if none
+//   of them may fail that, such as an index or a divisor.
+// - A function scope `var` without initializer which is assigned exactly once, before any use and in the block
+//   declaring it, is declared at the assignment instead.
+// - A `let` whose initializer is a const-expression becomes a `const`, under the same condition.
+class PromoteVariables final : public tint::Castable<PromoteVariables, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,108 @@
+#include "prune_struct_members.h"
+
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/struct.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/sem/struct.h>
+#include <src/tint/lang/wgsl/sem/value_constructor.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::PruneStructMembers);
+
+namespace wgslx::minifier {
+
+struct PrunedStruct {
+    const tint::ast::Struct* declaration;
+    std::vector<bool> used;
+    std::vector<const tint::sem::Call*> constructors;
+};
+
+PruneStructMembers::ApplyResult PruneStructMembers::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    std::unordered_map<const tint::core::type::Struct*, PrunedStruct> structs;
+    for (const auto* decl : program.AST().TypeDecls()) {
+        const auto* str = decl->As<tint::ast::Struct>();
+        const auto* sem = str ? program.Sem().Get(str) : nullptr;
+        if (!sem || sem->IsHostShareable() || !sem->PipelineStageUses().IsEmpty()) {
+            continue;
+        }
+        structs.emplace(sem, PrunedStruct {.declaration = str, .used = std::vector<bool>(str->members.Length())});
+    }
+    if (structs.empty()) {
+        return SkipTransform;
+    }
+
+    for (const auto* node : program.AST().GlobalDeclarations()) {
+        TraverseNodes<tint::ast::Expression>(node, [&](const tint::ast::Expression* expr) {
+            const auto* sem = program.Sem().Get(expr);
+            const auto* value = sem ? sem->As<tint::sem::ValueExpression>() : nullptr;
+            if (!value) {
+                return;
+            }
+            value = value->Unwrap();
+            if (const auto* access = value->As<tint::sem::StructMemberAccess>()) {
+                auto iter = structs.find(access->Member()->Struct());
+                if (iter != structs.end()) {
+                    iter->second.used[access->Member()->Index()] = true;
+                }
+            } else if (const auto* call = value->As<tint::sem::Call>()) {
+                if (!call->Target()->Is<tint::sem::ValueConstructor>()) {
+                    return;
+                }
+                auto iter = structs.find(call->Type()->As<tint::core::type::Struct>());
+                if (iter != structs.end()) {
+                    iter->second.constructors.push_back(call);
+                }
+            }
+        });
+    }
+
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+    for (auto& [_, str] : structs) {
+        // Arguments with side effects must still be evaluated
+        for (const auto* call : str.constructors) {
+            for (std::size_t i = 0; i < call->Arguments().Length(); ++i) {
+                if (call->Arguments()[i]->HasSideEffects()) {
+                    str.used[i] = true;
+                }
+            }
+        }
+        // A struct needs at least one member
+        if (std::none_of(str.used.begin(), str.used.end(), [](bool used) { return used; })) {
+            str.used[0] = true;
+        }
+
+        const auto& members = str.declaration->members;
+        for (std::size_t i = 0; i < members.Length(); ++i) {
+            if (str.used[i]) {
+                continue;
+            }
+            ctx.Remove(members, members[i]);
+            for (const auto* call : str.constructors) {
+                // The zero value constructor has no arguments
+                const auto& args = call->Declaration()->args;
+                if (!args.IsEmpty()) {
+                    ctx.Remove(args, args[i]);
+                }
+            }
+        }
+    }
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
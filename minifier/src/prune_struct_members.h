@@ -0,0 +1,18 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Removes the members of structs which are never accessed, as long as the struct layout can't be observed outside
+// of the shader: it isn't used by any host shareable address space or as pipeline stage input or output.
+class PruneStructMembers final : public tint::Castable<PruneStructMembers, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,108 @@
+#include "purity.h"
+
+#include <src/tint/lang/core/builtin_fn.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/discard_statement.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/phony_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/sem/builtin_fn.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/function.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+
+#include <vector>
+
+#include "stores.h"
+#include "traverser.h"
+
+namespace wgslx::minifier {
+
+static const tint::sem::Call* GetCall(const tint::Program& program, const tint::ast::CallExpression* call) {
+    const auto* sem = program.Sem().Get(call);
+    const auto* value = sem ? sem->As<tint::sem::ValueExpression>() : nullptr;
+    return value ? value->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+}
+
+Purity::Purity(const tint::Program& program) : program_(program) {
+    std::vector<const tint::ast::Function*> worklist;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body || HasOwnSideEffects(function)) {
+            impure_.insert(function);
+            worklist.push_back(function);
+        }
+    }
+
+    // Callers of an impure function are impure too
+    while (!worklist.empty()) {
+        const auto* function = worklist.back();
+        worklist.pop_back();
+        const auto* sem = program.Sem().Get(function);
+        if (!sem) {
+            continue;
+        }
+        for (const auto* call : sem->CallSites()) {
+            const auto* caller = call->Stmt() ? call->Stmt()->Function() : nullptr;
+            if (caller && impure_.insert(caller->Declaration()).second) {
+                worklist.push_back(caller->Declaration());
+            }
+        }
+    }
+}
+
+bool Purity::IsPure(const tint::ast::Expression* expr) const {
+    return TraverseNodes<tint::ast::CallExpression>(expr, [&](const tint::ast::CallExpression* call) {
+        return IsPureCall(call) ? TraverseAction::Continue : TraverseAction::Stop;
+    });
+}
+
+bool Purity::IsPureCall(const tint::ast::CallExpression* call) const {
+    const auto* sem = GetCall(program_, call);
+    if (!sem) {
+        return false;
+    }
+    if (const auto* function = sem->Target()->As<tint::sem::Function>()) {
+        return IsPure(function->Declaration());
+    }
+    if (const auto* builtin = sem->Target()->As<tint::sem::BuiltinFn>()) {
+        return !builtin->HasSideEffects() && !builtin->IsBarrier() &&
+               builtin->Fn() != tint::core::BuiltinFn::kWorkgroupUniformLoad;
+    }
+    // Value constructors and conversions
+    return true;
+}
+
+bool Purity::HasOwnSideEffects(const tint::ast::Function* function) const {
+    return !TraverseNodes<tint::ast::Node>(function->body, [&](const tint::ast::Node* node) {
+        if (node->Is<tint::ast::DiscardStatement>()) {
+            return TraverseAction::Stop;
+        }
+        // Calls of user functions are handled by propagating impurity to the callers
+        if (const auto* call = node->As<tint::ast::CallExpression>()) {
+            const auto* sem = GetCall(program_, call);
+            if (!sem || (!sem->Target()->Is<tint::sem::Function>() && !IsPureCall(call))) {
+                return TraverseAction::Stop;
+            }
+            return TraverseAction::Continue;
+        }
+
+        const auto* stmt = node->As<tint::ast::Statement>();
+        const auto* target = stmt ? StoreTarget(stmt) : nullptr;
+        if (!target || target->Is<tint::ast::PhonyExpression>()) {
+            return TraverseAction::Continue;
+        }
+        // Only writes to function scope variables declared in this function are invisible to the caller
+        const auto* root = StoreRoot(target)->As<tint::ast::IdentifierExpression>();
+        const auto* user = root ? program_.Sem().Get<tint::sem::VariableUser>(root) : nullptr;
+        if (!user || !user->Variable()->Is<tint::sem::LocalVariable>() ||
+            !user->Variable()->Declaration()->Is<tint::ast::Var>()) {
+            return TraverseAction::Stop;
+        }
+        return TraverseAction::Continue;
+    });
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/expression.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/program/program.h>
+
+#include <unordered_set>
+
+namespace wgslx::minifier {
+
+// Which user functions have side effects. The resolver conservatively treats every call of a user function as
+// having side effects, while a function is pure here if it only writes its own function scope variables and
+// doesn't discard, call a builtin with side effects or call an impure function.
+class Purity {
+ public:
+    explicit Purity(const tint::Program& program);
+
+    [[nodiscard]] bool IsPure(const tint::ast::Function* function) const {
+        return !impure_.contains(function);
+    }
+
+    // Whether evaluating `expr` has no side effects
+    [[nodiscard]] bool IsPure(const tint::ast::Expression* expr) const;
+
+ private:
+    const tint::Program& program_;
+    std::unordered_set<const tint::ast::Function*> impure_;
+
+    [[nodiscard]] bool HasOwnSideEffects(const tint::ast::Function* function) const;
+    [[nodiscard]] bool IsPureCall(const tint::ast::CallExpression* call) const;
+};
+
+}  // namespace wgslx::minifier
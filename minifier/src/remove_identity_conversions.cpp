@@ -0,0 +1,62 @@
+#include "remove_identity_conversions.h"
+
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/value_constructor.h>
+#include <src/tint/lang/wgsl/sem/value_conversion.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::RemoveIdentityConversions);
+
+namespace wgslx::minifier {
+
+static bool IsIdentity(const tint::Program& program, const tint::ast::CallExpression* call) {
+    const auto* sem = program.Sem().Get(call);
+    const auto* value = sem ? sem->As<tint::sem::ValueExpression>() : nullptr;
+    const auto* target = value ? value->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+    if (!target || !target->Target()->IsAnyOf<tint::sem::ValueConversion, tint::sem::ValueConstructor>() ||
+        call->args.Length() != 1) {
+        return false;
+    }
+    // The type of the argument before materialization, so that `f32(1)` is kept
+    const auto* arg = program.Sem().GetVal(call->args[0])->UnwrapMaterialize();
+    return arg->Type()->UnwrapRef() == target->Type();
+}
+
+RemoveIdentityConversions::ApplyResult RemoveIdentityConversions::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto removed = false;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::CallExpression>(function->body, [&](const tint::ast::CallExpression* call) {
+            if (IsIdentity(program, call)) {
+                // Cloned lazily, so nested conversions are removed too
+                ctx.Replace(call, [&ctx, call] { return ctx.Clone(call->args[0]); });
+                removed = true;
+            }
+        });
+    }
+    if (!removed) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Removes value conversions and constructors with a single argument of the type they construct, such as `f32(x)`
+// or `vec4f(v)` where `x: f32` and `v: vec4f`. An abstract argument is kept converted, as it would otherwise
+// materialize to a different type.
+class RemoveIdentityConversions final
+    : public tint::Castable<RemoveIdentityConversions, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,70 @@
+#include "remove_pure_calls.h"
+
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/call_statement.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/phony_expression.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+
+#include "purity.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::RemovePureCalls);
+
+namespace wgslx::minifier {
+
+// The expression evaluated only for its side effects
+static const tint::ast::Expression* DiscardedExpression(const tint::ast::Statement* stmt) {
+    if (const auto* call = stmt->As<tint::ast::CallStatement>()) {
+        return call->expr;
+    }
+    if (const auto* assign = stmt->As<tint::ast::AssignmentStatement>()) {
+        if (assign->lhs->Is<tint::ast::PhonyExpression>()) {
+            return assign->rhs;
+        }
+    }
+    return nullptr;
+}
+
+RemovePureCalls::ApplyResult RemovePureCalls::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    Purity purity(program);
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto removed = false;
+    for (const auto* function : program.AST().Functions()) {
+        if (!function->body) {
+            continue;
+        }
+        TraverseNodes<tint::ast::Statement>(function->body, [&](const tint::ast::Statement* stmt) {
+            const auto* expr = DiscardedExpression(stmt);
+            if (!expr || !purity.IsPure(expr)) {
+                return;
+            }
+            // Statements of for loop headers can't simply be removed
+            const auto* sem = program.Sem().Get(stmt);
+            const auto* block = sem && sem->Parent() ? sem->Parent()->Declaration()->As<tint::ast::BlockStatement>()
+                                                     : nullptr;
+            if (block) {
+                ctx.Remove(block->statements, stmt);
+                removed = true;
+            }
+        });
+    }
+    if (!removed) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
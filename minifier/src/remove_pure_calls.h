@@ -0,0 +1,18 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Removes call statements and phony assignments such as `_ = f(x);` whose expression has no side effects, see
+// Purity. Functions which are no longer called are left to RemoveUseless.
+class RemovePureCalls final : public tint::Castable<RemovePureCalls, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
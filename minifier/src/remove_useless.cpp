@@ -1,202 +1,383 @@
 #include "remove_useless.h"
 
-#include <src/tint/lang/wgsl/ast/const.h>
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/call_statement.h>
+#include <src/tint/lang/wgsl/ast/compound_assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/const_assert.h>
 #include <src/tint/lang/wgsl/ast/function.h>
-#include <src/tint/lang/wgsl/ast/identifier.h>
-#include <src/tint/lang/wgsl/ast/traverse_expressions.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/increment_decrement_statement.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
 #include <src/tint/lang/wgsl/program/clone_context.h>
 #include <src/tint/lang/wgsl/program/program_builder.h>
 #include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/function.h>
+#include <src/tint/lang/wgsl/sem/statement.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
 #include <src/tint/utils/symbol/symbol.h>
 
-#include <range/v3/range/conversion.hpp>
-#include <range/v3/view/filter.hpp>
-#include <range/v3/view/transform.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
-#include <utility>
-#include <variant>
 #include <vector>
 
+#include "declaration_graph.h"
+#include "purity.h"
+#include "stores.h"
 #include "traverser.h"
 
 TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::RemoveUseless);
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::RemoveUseless::Config);
 
 namespace wgslx::minifier {
 
-template<class... Ts>
-struct Match : Ts... {
-    using Ts::operator()...;
-};
-
-template<class... Ts>
-Match(Ts...) -> Match<Ts...>;
-
-template<typename... Ts, typename... Fs>
-constexpr decltype(auto) operator|(const std::variant<Ts...>& v, const Match<Fs...>& match) {
-    return std::visit(match, v);
-}
-
-class Entity {
- public:
-    explicit Entity(const tint::ast::Function* ptr) : ptr_(ptr) {}
-    explicit Entity(const tint::ast::Const* ptr) : ptr_(ptr) {}
+static std::vector<const tint::ast::Node*> FindGlobalUseless(
+    const tint::Program& program,
+    const RemoveUseless::Config* config
+) {
+    DeclarationGraph graph(program);
 
-    [[nodiscard]] tint::Symbol Symbol() const {
-        return ptr_ | Match {
-                          [](const tint::ast::Function* f) { return f->name->symbol; },
-                          [](const tint::ast::Const* c) { return c->name->symbol; },
-                      };
+    auto roots = graph.EntryPoints();
+    if (config) {
+        std::erase_if(roots, [&](DeclarationGraph::Id id) {
+            auto name = graph.Declaration(id)->As<tint::ast::Function>()->name->symbol.Name();
+            return std::find(config->entry_points.begin(), config->entry_points.end(), name) ==
+                   config->entry_points.end();
+        });
     }
 
-    [[nodiscard]] const tint::ast::Node* Ptr() const {
-        return ptr_ | Match {
-                          [](const tint::ast::Function* f) -> const tint::ast::Node* { return f; },
-                          [](const tint::ast::Const* c) -> const tint::ast::Node* { return c; },
-                      };
+    // Module scope assertions must still resolve
+    for (const auto* assertion : program.AST().ConstAsserts()) {
+        auto refs = graph.References(assertion);
+        roots.insert(roots.end(), refs.begin(), refs.end());
     }
+    auto reached = graph.Reach(roots);
 
-    [[nodiscard]] bool IsEntryPoint() const {
-        return ptr_ | Match {
-                          [](const tint::ast::Function* f) { return f->IsEntryPoint(); },
-                          [](const tint::ast::Const* /* c */) { return false; },
-                      };
+    std::vector<const tint::ast::Node*> useless;
+    for (DeclarationGraph::Id id = 0; id < graph.Size(); ++id) {
+        if (!reached[id]) {
+            useless.push_back(graph.Declaration(id));
+        }
     }
+    return useless;
+}
 
- private:
-    std::variant<const tint::ast::Function*, const tint::ast::Const*> ptr_;
-};
+using RemovedArguments = std::unordered_map<const tint::ast::Function*, std::vector<const tint::ast::Expression*>>;
 
-struct Element {
-    Entity self;
-    std::unordered_set<tint::Symbol> refs;
-    bool visited = false;
-};
+// Drops the parameters of a non entry point function which are never read, together with the matching argument of
+// every call site. A parameter is kept if any of its arguments has side effects. The removed arguments are recorded
+// by the function containing the call, so the locals they read can be released.
+static void RemoveUnusedParameters(
+    tint::program::CloneContext& ctx,
+    const Purity& purity,
+    const tint::ast::Function* function,
+    RemovedArguments& removed
+) {
+    const auto* sem = ctx.src->Sem().Get(function);
+    if (!sem || function->IsEntryPoint()) {
+        return;
+    }
 
-using Elements = std::unordered_map<tint::Symbol, Element>;
-
-static Elements CollectElements(const tint::Program& program) {
-    auto elements = program.AST().GlobalDeclarations() | ranges::views::filter([](const tint::ast::Node* node) {
-                        return node->Is<tint::ast::Function>() || node->Is<tint::ast::Const>();
-                    }) |
-                    ranges::views::transform([](const tint::ast::Node* node) {
-                        if (node->Is<tint::ast::Function>()) {
-                            const auto* function = node->As<tint::ast::Function>();
-                            return std::make_pair(function->name->symbol, Element {.self = Entity(function)});
-                        } else {
-                            const auto* c = node->As<tint::ast::Const>();
-                            return std::make_pair(c->name->symbol, Element {.self = Entity(c)});
-                        }
-                    }) |
-                    ranges::to<Elements>();
-
-    for (const auto* node : program.AST().GlobalDeclarations()) {
-        tint::Symbol symbol;
-        const tint::ast::Statement* statement = nullptr;
-        const tint::ast::Expression* expression = nullptr;
-        if (node->Is<tint::ast::Function>()) {
-            const auto* function = node->As<tint::ast::Function>();
-            symbol = function->name->symbol;
-            statement = function->body;
-        } else if (node->Is<tint::ast::Const>()) {
-            const auto* c = node->As<tint::ast::Const>();
-            symbol = c->name->symbol;
-            expression = c->initializer;
-        } else {
+    for (std::size_t i = 0; i < function->params.Length(); ++i) {
+        const auto* param = function->params[i];
+        const auto* sem_param = ctx.src->Sem().Get(param);
+        if (!sem_param || !sem_param->Users().IsEmpty()) {
             continue;
         }
 
-        auto iter = elements.find(symbol);
-        if (iter == elements.end()) {
+        auto removable = true;
+        for (const auto* call : sem->CallSites()) {
+            if (!purity.IsPure(call->Declaration()->args[i]) || !call->Stmt()) {
+                removable = false;
+                break;
+            }
+        }
+        if (!removable) {
             continue;
         }
 
-        auto& refs = iter->second.refs;
-        Traverse(statement, [&](const tint::ast::Identifier* i) {
-            if (elements.contains(i->symbol)) {
-                refs.emplace(i->symbol);
-            }
-        });
-        Traverse(expression, [&](const tint::ast::Identifier* i) {
-            if (elements.contains(i->symbol)) {
-                refs.emplace(i->symbol);
-            }
-        });
+        ctx.Remove(function->params, param);
+        for (const auto* call : sem->CallSites()) {
+            const auto* arg = call->Declaration()->args[i];
+            ctx.Remove(call->Declaration()->args, arg);
+            removed[call->Stmt()->Function()->Declaration()].push_back(arg);
+        }
     }
+}
 
-    return elements;
+// Statements after which execution always continues with the next statement of the block
+static bool IsStraightLine(const tint::ast::Statement* stmt) {
+    return stmt->IsAnyOf<
+        tint::ast::AssignmentStatement,
+        tint::ast::CompoundAssignmentStatement,
+        tint::ast::IncrementDecrementStatement,
+        tint::ast::CallStatement,
+        tint::ast::VariableDeclStatement,
+        tint::ast::ConstAssert>();
 }
 
-static void MarkVisited(Elements& elements, const tint::Symbol& symbol) {
-    auto iter = elements.find(symbol);
-    if (iter == elements.end()) {
-        return;
+// Removes local declarations which are never read, together with the statements which only write them, and
+// stores which are overwritten before they can be read. Each removal may make more declarations dead, those are
+// processed from a worklist.
+class DeadLocals {
+ public:
+    DeadLocals(tint::program::CloneContext* ctx, const Purity* purity) : ctx_(ctx), purity_(purity) {}
+
+    // `released` are expressions of the function already removed by an earlier step
+    void Run(const tint::ast::Function* function, const std::vector<const tint::ast::Expression*>& released) {
+        if (!function->body) {
+            return;
+        }
+
+        Collect(function);
+        for (const auto* expr : released) {
+            Release(expr);
+        }
+        RemoveOverwrittenStores();
+
+        for (std::uint32_t i = 0; i < locals_.size(); ++i) {
+            if (locals_[i].reads == 0) {
+                worklist_.push_back(i);
+            }
+        }
+        while (!worklist_.empty()) {
+            auto i = worklist_.back();
+            worklist_.pop_back();
+            RemoveLocal(locals_[i]);
+        }
     }
 
-    if (iter->second.visited) {
-        return;
+ private:
+    struct Store {
+        const tint::ast::BlockStatement* block;
+        const tint::ast::Statement* stmt;
+    };
+
+    struct Local {
+        const tint::ast::BlockStatement* block;
+        const tint::ast::VariableDeclStatement* decl;
+        // Statements which only write the variable
+        std::vector<Store> stores;
+        std::size_t reads = 0;
+        bool address_taken = false;
+        bool removed = false;
+    };
+
+    struct Use {
+        std::uint32_t local;
+        bool store;
+    };
+
+    tint::program::CloneContext* ctx_;
+    const Purity* purity_;
+    std::vector<Local> locals_;
+    std::vector<const tint::ast::BlockStatement*> blocks_;
+    std::unordered_map<const tint::ast::IdentifierExpression*, Use> uses_;
+    std::unordered_set<const tint::ast::Statement*> removed_;
+    // Reads already counted down, a removed argument may also be inside a removed declaration or store
+    std::unordered_set<const tint::ast::IdentifierExpression*> released_;
+    std::vector<std::uint32_t> worklist_;
+
+    [[nodiscard]] bool HasSideEffects(const tint::ast::Expression* expr) const {
+        return !purity_->IsPure(expr);
     }
-    iter->second.visited = true;
 
-    for (const auto& s : iter->second.refs) {
-        MarkVisited(elements, s);
+    void Collect(const tint::ast::Function* function) {
+        std::unordered_map<const tint::sem::Variable*, std::uint32_t> ids;
+        std::vector<const tint::ast::Expression*> address_of;
+        TraverseNodes<tint::ast::Node>(function->body, [&](const tint::ast::Node* node) {
+            if (const auto* block = node->As<tint::ast::BlockStatement>()) {
+                blocks_.push_back(block);
+                for (const auto* stmt : block->statements) {
+                    if (const auto* decl = stmt->As<tint::ast::VariableDeclStatement>()) {
+                        if (const auto* sem = ctx_->src->Sem().Get(decl->variable)) {
+                            ids.emplace(sem, static_cast<std::uint32_t>(locals_.size()));
+                            locals_.push_back({.block = block, .decl = decl});
+                        }
+                    }
+                }
+            } else if (const auto* unary = node->As<tint::ast::UnaryOpExpression>()) {
+                if (unary->op == tint::core::UnaryOp::kAddressOf) {
+                    address_of.push_back(StoreRoot(unary->expr));
+                }
+            }
+        });
+
+        for (const auto& [sem, i] : ids) {
+            auto& local = locals_[i];
+            for (const auto* user : sem->Users()) {
+                const auto* block = StoreBlock(user);
+                auto store = block && local.decl->variable->Is<tint::ast::Var>();
+                uses_.emplace(user->Declaration(), Use {.local = i, .store = store});
+                if (store) {
+                    local.stores.push_back({.block = block, .stmt = user->Stmt()->Declaration()});
+                } else {
+                    ++local.reads;
+                }
+            }
+        }
+
+        for (const auto* expr : address_of) {
+            const auto* ident = expr->As<tint::ast::IdentifierExpression>();
+            auto iter = ident ? uses_.find(ident) : uses_.end();
+            if (iter != uses_.end()) {
+                locals_[iter->second.local].address_taken = true;
+            }
+        }
     }
-}
 
-static std::vector<const tint::ast::Node*> FindGlobalUseless(const tint::Program& program) {
-    auto elements = CollectElements(program);
-    for (const auto& [symbol, element] : elements) {
-        if (element.self.IsEntryPoint()) {
-            MarkVisited(elements, symbol);
+    // Returns the block of the statement if `user` is the variable an assignment, compound assignment or
+    // increment writes, and the statement can be removed from that block.
+    [[nodiscard]] const tint::ast::BlockStatement* StoreBlock(const tint::sem::VariableUser* user) const {
+        const auto* sem_stmt = user->Stmt();
+        if (!sem_stmt || !sem_stmt->Parent()) {
+            return nullptr;
+        }
+        const auto* target = StoreTarget(sem_stmt->Declaration());
+        if (!target || StoreRoot(target) != user->Declaration() || HasSideEffects(target)) {
+            return nullptr;
         }
+        return sem_stmt->Parent()->Declaration()->As<tint::ast::BlockStatement>();
     }
-    return elements | ranges::views::filter([](const auto& p) { return !p.second.visited; }) |
-           ranges::views::transform([](const auto& p) { return p.second.self.Ptr(); }) | ranges::to<std::vector>();
-}
 
-static void RemoveUselessVariables(tint::program::CloneContext* ctx, const tint::ast::BlockStatement* statement) {
-    std::unordered_map<tint::Symbol, std::pair<const tint::ast::VariableDeclStatement*, int>> vars;
-    for (const auto* statement : statement->statements) {
-        if (statement->Is<tint::ast::VariableDeclStatement>()) {
-            const auto* decl = statement->As<tint::ast::VariableDeclStatement>();
-            vars.emplace(decl->variable->name->symbol, std::make_pair(decl, 0));
-        } else if (statement->Is<tint::ast::BlockStatement>()) {
-            RemoveUselessVariables(ctx, statement->As<tint::ast::BlockStatement>());
+    // Within a block, `a = x;` is dead when a later `a = y;` comes first without any statement in between
+    // reading `a` or leaving the block.
+    void RemoveOverwrittenStores() {
+        for (const auto* block : blocks_) {
+            std::unordered_map<std::uint32_t, const tint::ast::AssignmentStatement*> pending;
+            for (const auto* stmt : block->statements) {
+                if (!IsStraightLine(stmt)) {
+                    pending.clear();
+                    continue;
+                }
+
+                const auto* assign = stmt->As<tint::ast::AssignmentStatement>();
+                const auto* target = assign ? assign->lhs->As<tint::ast::IdentifierExpression>() : nullptr;
+                TraverseNodes<tint::ast::IdentifierExpression>(stmt, [&](const tint::ast::IdentifierExpression* i) {
+                    auto iter = uses_.find(i);
+                    if (iter != uses_.end() && i != target) {
+                        pending.erase(iter->second.local);
+                    }
+                });
+
+                auto iter = target ? uses_.find(target) : uses_.end();
+                if (iter == uses_.end() || !iter->second.store) {
+                    continue;
+                }
+                auto i = iter->second.local;
+                if (locals_[i].address_taken) {
+                    continue;
+                }
+                if (auto previous = pending.find(i); previous != pending.end()) {
+                    removed_.insert(previous->second);
+                    ctx_->Remove(block->statements, previous->second);
+                    Release(previous->second->rhs);
+                    pending.erase(previous);
+                }
+                if (!HasSideEffects(assign->rhs)) {
+                    pending.emplace(i, assign);
+                }
+            }
         }
     }
 
-    Traverse(statement, [&](const tint::ast::Identifier* i) {
-        auto iter = vars.find(i->symbol);
-        if (iter != vars.end()) {
-            ++iter->second.second;
+    void RemoveLocal(Local& local) {
+        if (local.removed) {
+            return;
+        }
+        local.removed = true;
+
+        const auto* initializer = local.decl->variable->initializer;
+        if (initializer && HasSideEffects(initializer)) {
+            ctx_->Replace(local.decl, ctx_->dst->Assign(ctx_->dst->Phony(), ctx_->Clone(initializer)));
+        } else {
+            ctx_->Remove(local.block->statements, local.decl);
+            Release(initializer);
         }
-    });
 
-    for (const auto& [_, declAndCount] : vars) {
-        if (declAndCount.second == 1) {
-            ctx->Remove(statement->statements, declAndCount.first);
+        for (const auto& store : local.stores) {
+            if (!removed_.insert(store.stmt).second) {
+                continue;
+            }
+            const auto* value = StoreValue(store.stmt);
+            if (value && HasSideEffects(value)) {
+                ctx_->Replace(store.stmt, ctx_->dst->Assign(ctx_->dst->Phony(), ctx_->Clone(value)));
+            } else {
+                ctx_->Remove(store.block->statements, store.stmt);
+                Release(value);
+            }
+            Release(StoreTarget(store.stmt));
         }
     }
-}
 
-RemoveUseless::ApplyResult RemoveUseless::Apply(
-    const tint::Program& program,
-    const tint::ast::transform::DataMap& /* inputs */,
-    tint::ast::transform::DataMap& /* outputs */
-) const {
+    // Drops the reads inside a removed subtree
+    void Release(const tint::ast::Node* node) {
+        TraverseNodes<tint::ast::IdentifierExpression>(node, [&](const tint::ast::IdentifierExpression* i) {
+            auto iter = uses_.find(i);
+            if (iter == uses_.end() || iter->second.store || !released_.insert(i).second) {
+                return;
+            }
+            auto& local = locals_[iter->second.local];
+            if (local.reads > 0 && --local.reads == 0 && !local.removed) {
+                worklist_.push_back(iter->second.local);
+            }
+        });
+    }
+};
+
+// One round of removal, starting with the unreached global declarations
+static tint::Program RemoveOnce(const tint::Program& program, const std::vector<const tint::ast::Node*>& unreached) {
     tint::ProgramBuilder builder;
     tint::program::CloneContext ctx(&builder, &program, true);
-    for (const auto* node : FindGlobalUseless(*ctx.src)) {
+    std::unordered_set<const tint::ast::Node*> useless;
+    for (const auto* node : unreached) {
         ctx.Remove(ctx.src->AST().GlobalDeclarations(), node);
+        useless.insert(node);
     }
-    for (const auto* node : program.AST().GlobalDeclarations()) {
-        if (node->Is<tint::ast::Function>()) {
-            const auto* function = node->As<tint::ast::Function>();
-            RemoveUselessVariables(&ctx, function->body);
+
+    Purity purity(program);
+    RemovedArguments removed;
+    for (const auto* function : program.AST().Functions()) {
+        if (!useless.contains(function)) {
+            RemoveUnusedParameters(ctx, purity, function, removed);
         }
     }
+
+    static const std::vector<const tint::ast::Expression*> None;
+    for (const auto* function : program.AST().Functions()) {
+        if (useless.contains(function)) {
+            continue;
+        }
+        auto iter = removed.find(function);
+        DeadLocals(&ctx, &purity).Run(function, iter != removed.end() ? iter->second : None);
+    }
     ctx.Clone();
     return tint::resolver::Resolve(builder);
 }
 
+RemoveUseless::ApplyResult RemoveUseless::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& inputs,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    const auto* config = inputs.Get<Config>();
+    auto output = RemoveOnce(program, FindGlobalUseless(program, config));
+    // A function whose last call was in a removed local is only unreached in the next round
+    while (output.IsValid()) {
+        auto useless = FindGlobalUseless(output, config);
+        if (useless.empty()) {
+            break;
+        }
+        output = RemoveOnce(output, useless);
+    }
+    return output;
+}
+
 }  // namespace wgslx::minifier
@@ -1,11 +1,21 @@
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "src/tint/lang/wgsl/ast/transform/transform.h"
 
 namespace wgslx::minifier {
 
 class RemoveUseless final : public tint::Castable<RemoveUseless, tint::ast::transform::Transform> {
  public:
+    struct Config final : public Castable<Config, tint::ast::transform::Data> {
+        explicit Config(std::vector<std::string>&& e) : entry_points(std::move(e)) {}
+        // The entry points to keep, the others are removed together with everything only they reach
+        std::vector<std::string> entry_points;
+    };
+
     ApplyResult Apply(
         const tint::Program& program,
         const tint::ast::transform::DataMap& inputs,
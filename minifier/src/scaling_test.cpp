@@ -0,0 +1,174 @@
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+#include "minifier/minifier.h"
+#include "writer/writer.h"
+
+// Counts every byte allocated through the global operator new, so allocation growth can be checked
+static std::atomic<std::size_t> AllocatedBytes {0};
+
+void* operator new(std::size_t size) {
+    AllocatedBytes += size;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    std::abort();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept {
+    std::free(ptr);
+}
+
+namespace wgslx::minifier {
+
+struct ShaderOptions {
+    int functions = 1;
+    int depth = 1;
+    int table_size = 1;
+    // Length of a chain of single use lets in each function
+    int lets = 0;
+};
+
+// Generates large but valid WGSL: a const table, a binary tree of helper functions with chains of lets, nested
+// blocks and branches, and an entry point calling the root of the tree.
+static std::string GenerateShader(const ShaderOptions& options) {
+    std::string out = "const table = array<f32, " + std::to_string(options.table_size) + ">(";
+    for (auto i = 0; i < options.table_size; ++i) {
+        if (i != 0) {
+            out += ",";
+        }
+        out += std::to_string(i % 100) + ".5";
+    }
+    out += ");\n";
+
+    for (auto i = 0; i < options.functions; ++i) {
+        auto name = std::to_string(i);
+        out += "fn f" + name + "(x: f32) -> f32 {\n";
+        out += "  var a = x + table[" + std::to_string(i % options.table_size) + "];\n";
+        if (options.lets > 0) {
+            out += "  let l0 = x * 0.5;\n";
+            for (auto l = 1; l < options.lets; ++l) {
+                out += "  let l" + std::to_string(l) + " = l" + std::to_string(l - 1) + " * 0.5 + x;\n";
+            }
+            out += "  a = a + l" + std::to_string(options.lets - 1) + ";\n";
+        }
+        for (auto d = 0; d < options.depth; ++d) {
+            auto level = std::to_string(d);
+            out += d % 2 == 0 ? "  if (a > " + level + ".0) {\n" : "  {\n";
+            out += "  let t" + level + " = a * 0.5;\n";
+            out += "  let unused" + level + " = t" + level + " + 1.0;\n";
+            out += "  a = t" + level + " + " + level + ".0;\n";
+        }
+        for (auto d = 0; d < options.depth; ++d) {
+            out += "  }\n";
+        }
+        for (auto child : {2 * i + 1, 2 * i + 2}) {
+            if (child < options.functions) {
+                out += "  a = a + f" + std::to_string(child) + "(a);\n";
+            }
+        }
+        out += "  return a;\n}\n";
+    }
+
+    out += "@fragment fn main() -> @location(0) vec4f {\n  return vec4f(f0(1.0));\n}\n";
+    return out;
+}
+
+struct Cost {
+    double seconds;
+    std::size_t bytes;
+};
+
+static Cost Measure(const std::function<void()>& block) {
+    Cost cost {.seconds = 1e9, .bytes = 0};
+    // Best of three to filter out noise
+    for (auto i = 0; i < 3; ++i) {
+        auto bytes = AllocatedBytes.load();
+        auto start = std::chrono::steady_clock::now();
+        block();
+        auto end = std::chrono::steady_clock::now();
+        cost.seconds = std::min(cost.seconds, std::chrono::duration<double>(end - start).count());
+        cost.bytes = AllocatedBytes.load() - bytes;
+    }
+    return cost;
+}
+
+// Doubling the input must roughly double the cost of Minify and Write, not quadruple it. Allocations are
+// deterministic and always checked, wall clock time depends on the machine and is only reported unless asked for.
+static void ExpectLinear(const std::function<std::string(int)>& generate, int size, bool check_time = false) {
+    static constexpr double MaxTimeRatio = 3.0;
+    static constexpr double MaxMemoryRatio = 2.5;
+
+    Cost minify[2];
+    Cost write[2];
+    for (auto i = 0; i < 2; ++i) {
+        auto input = generate(size << i);
+        minify[i] = Measure([&] {
+            auto result = Minify(input, {});
+            ASSERT_FALSE(result.failed) << result.failure_message;
+        });
+
+        auto result = Minify(input, {});
+        write[i] = Measure([&] { writer::Write(result.program, {}); });
+    }
+
+    EXPECT_LT(static_cast<double>(minify[1].bytes) / static_cast<double>(minify[0].bytes), MaxMemoryRatio);
+    EXPECT_LT(static_cast<double>(write[1].bytes) / static_cast<double>(write[0].bytes), MaxMemoryRatio);
+
+    auto minify_time = minify[1].seconds / minify[0].seconds;
+    auto write_time = write[1].seconds / write[0].seconds;
+    testing::Test::RecordProperty("minify_time_ratio", std::to_string(minify_time));
+    testing::Test::RecordProperty("write_time_ratio", std::to_string(write_time));
+    if (check_time) {
+        EXPECT_LT(minify_time, MaxTimeRatio);
+        EXPECT_LT(write_time, MaxTimeRatio);
+    }
+}
+
+TEST(scaling, Functions) {
+    ExpectLinear([](int n) { return GenerateShader({.functions = n, .depth = 4, .table_size = 16}); }, 512);
+}
+
+TEST(scaling, Nesting) {
+    ExpectLinear([](int n) { return GenerateShader({.functions = 64, .depth = n, .table_size = 16}); }, 24);
+}
+
+TEST(scaling, ConstTable) {
+    ExpectLinear([](int n) { return GenerateShader({.functions = 16, .depth = 4, .table_size = n}); }, 2048);
+}
+
+TEST(scaling, Lets) {
+    ExpectLinear([](int n) { return GenerateShader({.functions = 16, .depth = 4, .table_size = 16, .lets = n}); }, 256);
+}
+
+// Run with --gtest_also_run_disabled_tests on a quiet machine
+TEST(scaling, DISABLED_Time) {
+    ExpectLinear([](int n) { return GenerateShader({.functions = n, .depth = 4, .table_size = 16}); }, 512, true);
+    ExpectLinear([](int n) { return GenerateShader({.functions = 64, .depth = n, .table_size = 16}); }, 24, true);
+    ExpectLinear([](int n) { return GenerateShader({.functions = 16, .depth = 4, .table_size = n}); }, 2048, true);
+    ExpectLinear(
+        [](int n) { return GenerateShader({.functions = 16, .depth = 4, .table_size = 16, .lets = n}); }, 256, true
+    );
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(scaling, DISABLED_Huge) {
+    auto input = GenerateShader({.functions = 100000, .depth = 8, .table_size = 4096});
+    auto result = Minify(input, {});
+    ASSERT_FALSE(result.failed) << result.failure_message;
+    EXPECT_FALSE(writer::Write(result.program, {}).wgsl.empty());
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,153 @@
+#include "shorten_assignments.h"
+
+#include <src/tint/lang/core/binary_op.h>
+#include <src/tint/lang/core/type/matrix.h>
+#include <src/tint/lang/core/type/scalar.h>
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/compound_assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+#include "constants.h"
+#include "expressions.h"
+#include "purity.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::ShortenAssignments);
+
+namespace wgslx::minifier {
+
+// Operators with a compound assignment form, the logical `&&` and `||` have none
+static bool HasCompoundForm(tint::core::BinaryOp op) {
+    switch (op) {
+        case tint::core::BinaryOp::kAnd:
+        case tint::core::BinaryOp::kOr:
+        case tint::core::BinaryOp::kXor:
+        case tint::core::BinaryOp::kAdd:
+        case tint::core::BinaryOp::kSubtract:
+        case tint::core::BinaryOp::kMultiply:
+        case tint::core::BinaryOp::kDivide:
+        case tint::core::BinaryOp::kModulo:
+        case tint::core::BinaryOp::kShiftLeft:
+        case tint::core::BinaryOp::kShiftRight:
+            return true;
+        default:
+            return false;
+    }
+}
+
+class Shortener {
+ public:
+    explicit Shortener(tint::program::CloneContext* ctx) : ctx_(ctx), program_(*ctx->src), purity_(program_) {}
+
+    bool Run() {
+        auto shortened = false;
+        for (const auto* node : program_.AST().GlobalDeclarations()) {
+            TraverseNodes<tint::ast::Statement>(node, [&](const tint::ast::Statement* stmt) {
+                if (const auto* assign = stmt->As<tint::ast::AssignmentStatement>()) {
+                    shortened = Assignment(assign) || shortened;
+                } else if (const auto* compound = stmt->As<tint::ast::CompoundAssignmentStatement>()) {
+                    shortened = Increment(compound, compound->lhs, compound->rhs, compound->op) || shortened;
+                }
+            });
+        }
+        return shortened;
+    }
+
+ private:
+    tint::program::CloneContext* ctx_;
+    const tint::Program& program_;
+    Purity purity_;
+
+    // Whether `a op b` is `b op a`, which is also exact for floats, but not for products of a matrix with a vector
+    // or matrix
+    bool IsCommutative(const tint::ast::BinaryExpression* binary) const {
+        switch (binary->op) {
+            case tint::core::BinaryOp::kAnd:
+            case tint::core::BinaryOp::kOr:
+            case tint::core::BinaryOp::kXor:
+            case tint::core::BinaryOp::kAdd:
+                return true;
+            case tint::core::BinaryOp::kMultiply: {
+                const auto* lhs = GetValue(program_, binary->lhs)->Type()->UnwrapRef();
+                const auto* rhs = GetValue(program_, binary->rhs)->Type()->UnwrapRef();
+                return lhs->Is<tint::core::type::Scalar>() || rhs->Is<tint::core::type::Scalar>() ||
+                       (!lhs->Is<tint::core::type::Matrix>() && !rhs->Is<tint::core::type::Matrix>());
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool Assignment(const tint::ast::AssignmentStatement* assign) {
+        const auto* binary = assign->rhs->As<tint::ast::BinaryExpression>();
+        const auto* target = GetValue(program_, assign->lhs);
+        const auto* value = binary ? GetValue(program_, binary) : nullptr;
+        if (!value || !target || !HasCompoundForm(binary->op) ||
+            value->Type() != target->Type()->UnwrapRef() || !purity_.IsPure(assign->lhs)) {
+            return false;
+        }
+
+        // The operand is evaluated after the target is loaded, it may only move before the load if it is pure
+        const tint::ast::Expression* operand = nullptr;
+        if (IsSameExpression(program_, assign->lhs, binary->lhs)) {
+            operand = binary->rhs;
+        } else if (IsCommutative(binary) && IsSameExpression(program_, assign->lhs, binary->rhs) &&
+                   purity_.IsPure(binary->lhs)) {
+            operand = binary->lhs;
+        } else {
+            return false;
+        }
+
+        if (!Increment(assign, assign->lhs, operand, binary->op)) {
+            ctx_->Replace(assign, [ctx = ctx_, assign, operand, op = binary->op] {
+                return ctx->dst->CompoundAssign(ctx->Clone(assign->lhs), ctx->Clone(operand), op);
+            });
+        }
+        return true;
+    }
+
+    // Replaces `stmt` storing `lhs op operand` with an increment or decrement if it adds or subtracts one to an integer
+    bool Increment(
+        const tint::ast::Statement* stmt,
+        const tint::ast::Expression* lhs,
+        const tint::ast::Expression* operand,
+        tint::core::BinaryOp op
+    ) {
+        const auto* target = GetValue(program_, lhs);
+        const auto* value = GetValue(program_, operand);
+        if (!target || !value || !target->Type()->UnwrapRef()->IsIntegerScalar() ||
+            (op != tint::core::BinaryOp::kAdd && op != tint::core::BinaryOp::kSubtract) ||
+            !IsSplatOf(value->ConstantValue(), 1.0)) {
+            return false;
+        }
+        ctx_->Replace(stmt, [ctx = ctx_, lhs, op] {
+            return op == tint::core::BinaryOp::kAdd ? ctx->dst->Increment(ctx->Clone(lhs))
+                                                    : ctx->dst->Decrement(ctx->Clone(lhs));
+        });
+        return true;
+    }
+};
+
+ShortenAssignments::ApplyResult ShortenAssignments::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    Shortener shortener(&ctx);
+    if (!shortener.Run()) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Rewrites assignments of an operation on the target such as `a.x = a.x * 2.0` to compound assignments `a.x *= 2.0`,
+// and adding or subtracting one to an integer to increments and decrements `i++`. Targets are evaluated once
+// instead of twice, so they must not call functions with side effects.
+class ShortenAssignments final : public tint::Castable<ShortenAssignments, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,77 @@
+#include "shorten_constructors.h"
+
+#include <src/tint/lang/core/type/matrix.h>
+#include <src/tint/lang/core/type/vector.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/value_constructor.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+
+#include <algorithm>
+
+#include "constants.h"
+#include "constructors.h"
+#include "expressions.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::ShortenConstructors);
+
+namespace wgslx::minifier {
+
+// Whether the arguments of a vector constructor are the same scalar, which also infers the same type on its own
+static bool IsSplat(const tint::Program& program, const tint::ast::CallExpression* call) {
+    const auto& args = call->args;
+    if (args.Length() < 2) {
+        return false;
+    }
+    const auto* first = GetValue(program, args[0]);
+    return std::all_of(args.begin(), args.end(), [&](const tint::ast::Expression* arg) {
+        const auto* sem = GetValue(program, arg);
+        return IsSameScalar(first->ConstantValue(), sem->ConstantValue()) &&
+               (!IsInferringConstructor(call) ||
+                sem->UnwrapMaterialize()->Type() == first->UnwrapMaterialize()->Type());
+    });
+}
+
+ShortenConstructors::ApplyResult ShortenConstructors::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto shortened = false;
+    for (const auto* node : program.AST().GlobalDeclarations()) {
+        TraverseNodes<tint::ast::CallExpression>(node, [&](const tint::ast::CallExpression* call) {
+            const auto* sem = GetValue(program, call);
+            const auto* target = sem ? sem->UnwrapMaterialize()->As<tint::sem::Call>() : nullptr;
+            if (!target || !target->Target()->Is<tint::sem::ValueConstructor>() || call->args.IsEmpty() ||
+                !target->Type()->IsAnyOf<tint::core::type::Vector, tint::core::type::Matrix>()) {
+                return;
+            }
+
+            if (!IsInferringConstructor(call) && IsSplatOf(sem->ConstantValue(), 0.0)) {
+                ctx.Replace(call, [&ctx, call] { return ctx.dst->Call(ctx.Clone(call->target)); });
+                shortened = true;
+            } else if (target->Type()->Is<tint::core::type::Vector>() && IsSplat(program, call)) {
+                ctx.Replace(call, [&ctx, call] {
+                    return ctx.dst->Call(ctx.Clone(call->target), ctx.Clone(call->args[0]));
+                });
+                shortened = true;
+            }
+        });
+    }
+    if (!shortened) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
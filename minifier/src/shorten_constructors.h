@@ -0,0 +1,19 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Rewrites constant vector and matrix constructors of zeros to the zero value form `vec3f()`, and vector
+// constructors of equal scalars to the splat form `vec4f(1)`. Constructors inferring their type keep an argument,
+// as `vec3()` has no type.
+class ShortenConstructors final : public tint::Castable<ShortenConstructors, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
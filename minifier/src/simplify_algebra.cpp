@@ -0,0 +1,222 @@
+#include "simplify_algebra.h"
+
+#include <src/tint/lang/core/binary_op.h>
+#include <src/tint/lang/core/builtin_fn.h>
+#include <src/tint/lang/core/type/bool.h>
+#include <src/tint/lang/core/type/f16.h>
+#include <src/tint/lang/core/type/f32.h>
+#include <src/tint/lang/core/type/matrix.h>
+#include <src/tint/lang/core/type/scalar.h>
+#include <src/tint/lang/core/unary_op.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/builtin_fn.h>
+#include <src/tint/lang/wgsl/sem/call.h>
+#include <src/tint/lang/wgsl/sem/value_expression.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "constants.h"
+#include "expressions.h"
+#include "purity.h"
+#include "traverser.h"
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::SimplifyAlgebra);
+
+namespace wgslx::minifier {
+
+using CreateType =
+    std::function<tint::ast::Type(tint::program::CloneContext& ctx, const tint::core::type::Type* type)>;
+
+class Simplifier {
+ public:
+    Simplifier(tint::program::CloneContext* ctx, const CreateType& create_type)
+        : ctx_(ctx), program_(*ctx->src), purity_(program_), create_type_(create_type) {}
+
+    bool Run() {
+        auto simplified = false;
+        for (const auto* function : program_.AST().Functions()) {
+            if (!function->body) {
+                continue;
+            }
+            TraverseNodes<tint::ast::Expression>(function->body, [&](const tint::ast::Expression* expr) {
+                const auto* sem = GetValue(program_, expr);
+                if (!sem || sem->ConstantValue()) {
+                    return;
+                }
+                auto replacement = tint::Switch(
+                    expr,
+                    [&](const tint::ast::BinaryExpression* binary) { return SimplifyBinary(binary); },
+                    [&](const tint::ast::UnaryOpExpression* unary) { return SimplifyUnary(unary); },
+                    [&](const tint::ast::CallExpression* call) { return SimplifySelect(call); },
+                    [&](tint::Default) { return Replacement {}; }
+                );
+                if (replacement.operand && Type(replacement.operand) == sem->Type()) {
+                    // Cloned lazily, so the operand is simplified too
+                    ctx_->Replace(expr, [this, operand = replacement.operand] { return ctx_->Clone(operand); });
+                    simplified = true;
+                } else if (replacement.zero) {
+                    ctx_->Replace(expr, ctx_->dst->Call(create_type_(*ctx_, sem->Type())));
+                    simplified = true;
+                }
+            });
+        }
+        return simplified;
+    }
+
+ private:
+    // Either an operand the expression is equal to, or the zero value of its type
+    struct Replacement {
+        const tint::ast::Expression* operand = nullptr;
+        bool zero = false;
+    };
+
+    tint::program::CloneContext* ctx_;
+    const tint::Program& program_;
+    Purity purity_;
+    const CreateType& create_type_;
+
+    [[nodiscard]] const tint::core::type::Type* Type(const tint::ast::Expression* expr) const {
+        return GetValue(program_, expr)->Type();
+    }
+
+    [[nodiscard]] bool IsConstant(const tint::ast::Expression* expr, double value) const {
+        return IsSplatOf(GetValue(program_, expr)->ConstantValue(), value);
+    }
+
+    [[nodiscard]] Replacement SimplifyBinary(const tint::ast::BinaryExpression* binary) const {
+        const auto* element = Type(binary)->DeepestElement();
+        auto is_float = element->IsAnyOf<tint::core::type::F32, tint::core::type::F16>();
+        auto is_bool = element->Is<tint::core::type::Bool>();
+        const auto* lhs = binary->lhs;
+        const auto* rhs = binary->rhs;
+        // The operand for which `identity` is the identity element, on either side if `commutative`
+        auto identity = [&](double value, bool commutative) -> Replacement {
+            if (IsConstant(rhs, value)) {
+                return {.operand = lhs};
+            }
+            if (commutative && IsConstant(lhs, value)) {
+                return {.operand = rhs};
+            }
+            return {};
+        };
+
+        switch (binary->op) {
+            case tint::core::BinaryOp::kMultiply:
+                // A matrix of ones isn't the identity of matrix multiplication
+                if (Type(lhs)->Is<tint::core::type::Matrix>() || Type(rhs)->Is<tint::core::type::Matrix>()) {
+                    if (Type(rhs)->Is<tint::core::type::Scalar>() && IsConstant(rhs, 1.0)) {
+                        return {.operand = lhs};
+                    }
+                    if (Type(lhs)->Is<tint::core::type::Scalar>() && IsConstant(lhs, 1.0)) {
+                        return {.operand = rhs};
+                    }
+                    return {};
+                }
+                // x * 0 is NaN for an infinite or NaN float, and -0.0 for a negative one
+                if (!is_float && ((IsConstant(rhs, 0.0) && purity_.IsPure(lhs)) ||
+                                  (IsConstant(lhs, 0.0) && purity_.IsPure(rhs)))) {
+                    return {.zero = true};
+                }
+                return identity(1.0, true);
+            case tint::core::BinaryOp::kDivide:
+                return identity(1.0, false);
+            case tint::core::BinaryOp::kAdd:
+                // -0.0 + 0.0 is 0.0
+                return identity(is_float ? -0.0 : 0.0, true);
+            case tint::core::BinaryOp::kSubtract:
+                return identity(0.0, false);
+            case tint::core::BinaryOp::kShiftLeft:
+            case tint::core::BinaryOp::kShiftRight:
+                return identity(0.0, false);
+            case tint::core::BinaryOp::kOr:
+            case tint::core::BinaryOp::kXor:
+            case tint::core::BinaryOp::kLogicalOr:
+                return identity(0.0, true);
+            case tint::core::BinaryOp::kAnd:
+            case tint::core::BinaryOp::kLogicalAnd:
+                return is_bool ? identity(1.0, true) : Replacement {};
+            default:
+                return {};
+        }
+    }
+
+    [[nodiscard]] static Replacement SimplifyUnary(const tint::ast::UnaryOpExpression* unary) {
+        const auto* inner = unary->expr->As<tint::ast::UnaryOpExpression>();
+        if (!inner) {
+            return {};
+        }
+        switch (unary->op) {
+            case tint::core::UnaryOp::kNegation:
+            case tint::core::UnaryOp::kNot:
+            case tint::core::UnaryOp::kComplement:
+                return inner->op == unary->op ? Replacement {.operand = inner->expr} : Replacement {};
+            case tint::core::UnaryOp::kIndirection:
+                return inner->op == tint::core::UnaryOp::kAddressOf ? Replacement {.operand = inner->expr}
+                                                                     : Replacement {};
+            case tint::core::UnaryOp::kAddressOf:
+                return inner->op == tint::core::UnaryOp::kIndirection ? Replacement {.operand = inner->expr}
+                                                                       : Replacement {};
+            default:
+                return {};
+        }
+    }
+
+    [[nodiscard]] Replacement SimplifySelect(const tint::ast::CallExpression* call) const {
+        const auto* sem = GetValue(program_, call)->UnwrapMaterialize()->As<tint::sem::Call>();
+        const auto* builtin = sem ? sem->Target()->As<tint::sem::BuiltinFn>() : nullptr;
+        if (!builtin || builtin->Fn() != tint::core::BuiltinFn::kSelect) {
+            return {};
+        }
+        const auto& args = call->args;
+        if (!IsSameExpression(program_, args[0], args[1]) || !purity_.IsPure(args[1]) || !purity_.IsPure(args[2])) {
+            return {};
+        }
+        return {.operand = args[0]};
+    }
+};
+
+static std::optional<tint::Program> Simplify(const tint::Program& program, const CreateType& create_type) {
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+    if (!Simplifier(&ctx, create_type).Run()) {
+        return std::nullopt;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+SimplifyAlgebra::ApplyResult SimplifyAlgebra::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& /* inputs */,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    CreateType create_type = [](tint::program::CloneContext& ctx, const tint::core::type::Type* type) {
+        return CreateASTTypeFor(ctx, type);
+    };
+    auto result = Simplify(program, create_type);
+    if (!result) {
+        return SkipTransform;
+    }
+    // Simplifications may expose others, such as `select(x * 1, x, c)`
+    while (result->IsValid()) {
+        auto next = Simplify(*result, create_type);
+        if (!next) {
+            break;
+        }
+        result = std::move(next);
+    }
+    return result;
+}
+
+}  // namespace wgslx::minifier
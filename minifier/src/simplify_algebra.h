@@ -0,0 +1,20 @@
+#pragma once
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Simplifies algebraic identities FoldConstants leaves, as their operands aren't all constant: `x * 1`, `x / 1`,
+// `x - 0`, `x + 0` for integers and `x + -0.0` for floats, integer `x * 0`, `x | 0`, `x << 0`, `b && true`,
+// `!!b`, `-(-x)`, `~~x`, `*&x`, `&*p` and `select(a, a, c)`. Float identities keep NaN and the sign of zero, the
+// type of the expression must not change and dropped operands must have no side effects. Runs to a fixed point.
+class SimplifyAlgebra final : public tint::Castable<SimplifyAlgebra, tint::ast::transform::Transform> {
+ public:
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
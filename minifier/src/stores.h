@@ -0,0 +1,50 @@
+#pragma once
+
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/compound_assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/expression.h>
+#include <src/tint/lang/wgsl/ast/increment_decrement_statement.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/statement.h>
+
+namespace wgslx::minifier {
+
+// The variable expression at the root of an assignment target such as `a.b[i]`
+inline const tint::ast::Expression* StoreRoot(const tint::ast::Expression* lhs) {
+    while (true) {
+        if (const auto* member = lhs->As<tint::ast::MemberAccessorExpression>()) {
+            lhs = member->object;
+        } else if (const auto* index = lhs->As<tint::ast::IndexAccessorExpression>()) {
+            lhs = index->object;
+        } else {
+            return lhs;
+        }
+    }
+}
+
+// The target of an assignment, compound assignment or increment
+inline const tint::ast::Expression* StoreTarget(const tint::ast::Statement* stmt) {
+    if (const auto* assign = stmt->As<tint::ast::AssignmentStatement>()) {
+        return assign->lhs;
+    }
+    if (const auto* compound = stmt->As<tint::ast::CompoundAssignmentStatement>()) {
+        return compound->lhs;
+    }
+    if (const auto* inc_dec = stmt->As<tint::ast::IncrementDecrementStatement>()) {
+        return inc_dec->lhs;
+    }
+    return nullptr;
+}
+
+inline const tint::ast::Expression* StoreValue(const tint::ast::Statement* stmt) {
+    if (const auto* assign = stmt->As<tint::ast::AssignmentStatement>()) {
+        return assign->rhs;
+    }
+    if (const auto* compound = stmt->As<tint::ast::CompoundAssignmentStatement>()) {
+        return compound->rhs;
+    }
+    return nullptr;
+}
+
+}  // namespace wgslx::minifier
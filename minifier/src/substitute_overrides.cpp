@@ -0,0 +1,131 @@
+#include "substitute_overrides.h"
+
+#include <src/tint/lang/core/number.h>
+#include <src/tint/lang/core/type/bool.h>
+#include <src/tint/lang/core/type/f16.h>
+#include <src/tint/lang/core/type/f32.h>
+#include <src/tint/lang/core/type/i32.h>
+#include <src/tint/lang/core/type/u32.h>
+#include <src/tint/lang/wgsl/ast/module.h>
+#include <src/tint/lang/wgsl/ast/override.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
+#include <src/tint/lang/wgsl/sem/variable.h>
+#include <src/tint/utils/rtti/switch.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::SubstituteOverrides);
+TINT_INSTANTIATE_TYPEINFO(wgslx::minifier::SubstituteOverrides::Config);
+
+namespace wgslx::minifier {
+
+// Whether an override of `type` can hold `value`, since converting one out of range is undefined behavior
+static bool IsRepresentable(const tint::core::type::Type* type, double value) {
+    auto in_range = [&](double lowest, double highest) { return value >= lowest && value <= highest; };
+    auto integral = std::trunc(value) == value;
+    return tint::Switch(
+        type,
+        [&](const tint::core::type::Bool*) { return value == 0.0 || value == 1.0; },
+        [&](const tint::core::type::I32*) {
+            return integral && in_range(tint::core::i32::kLowestValue, tint::core::i32::kHighestValue);
+        },
+        [&](const tint::core::type::U32*) {
+            return integral && in_range(tint::core::u32::kLowestValue, tint::core::u32::kHighestValue);
+        },
+        [&](const tint::core::type::F32*) {
+            return in_range(tint::core::f32::kLowestValue, tint::core::f32::kHighestValue);
+        },
+        [&](const tint::core::type::F16*) {
+            return in_range(tint::core::f16::kLowestValue, tint::core::f16::kHighestValue);
+        },
+        [&](tint::Default) { return true; }
+    );
+}
+
+// A literal of the override type, which keeps the type of the const the same without spelling it out
+static const tint::ast::Expression* CreateLiteral(
+    tint::ProgramBuilder& builder,
+    const tint::core::type::Type* type,
+    double value
+) {
+    return tint::Switch(
+        type,
+        [&](const tint::core::type::Bool*) { return builder.Expr(value != 0.0); },
+        [&](const tint::core::type::I32*) -> const tint::ast::Expression* {
+            // The lowest i32 has no literal, as the literal of its negation is out of range
+            if (value == tint::core::i32::kLowestValue) {
+                return builder.Call<tint::core::i32>(builder.Sub(
+                    builder.Expr(tint::core::i32(-tint::core::i32::kHighestValue)),
+                    builder.Expr(tint::core::i32(1))
+                ));
+            }
+            return builder.Expr(tint::core::i32(static_cast<std::int32_t>(value)));
+        },
+        [&](const tint::core::type::U32*) { return builder.Expr(tint::core::u32(static_cast<std::uint32_t>(value))); },
+        [&](const tint::core::type::F32*) { return builder.Expr(tint::core::f32(static_cast<float>(value))); },
+        [&](const tint::core::type::F16*) { return builder.Expr(tint::core::f16(static_cast<float>(value))); },
+        [&](tint::Default) -> const tint::ast::Expression* { return nullptr; }
+    );
+}
+
+SubstituteOverrides::ApplyResult SubstituteOverrides::Apply(
+    const tint::Program& program,
+    const tint::ast::transform::DataMap& inputs,
+    tint::ast::transform::DataMap& /* outputs */
+) const {
+    const auto* config = inputs.Get<Config>();
+    if (!config || config->values.empty()) {
+        return SkipTransform;
+    }
+
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &program, true);
+
+    auto substituted = false;
+    for (const auto* global : program.AST().GlobalVariables()) {
+        const auto* override = global->As<tint::ast::Override>();
+        const auto* sem = override ? program.Sem().Get(override) : nullptr;
+        if (!sem) {
+            continue;
+        }
+
+        auto iter = config->values.end();
+        if (const auto& id = sem->Attributes().override_id) {
+            iter = config->values.find(std::to_string(id->value));
+        }
+        if (iter == config->values.end()) {
+            iter = config->values.find(override->name->symbol.Name());
+        }
+        if (iter == config->values.end()) {
+            continue;
+        }
+
+        if (!IsRepresentable(sem->Type(), iter->second)) {
+            builder.Diagnostics().AddError(override->source)
+                << "value " << iter->second << " of override '" << override->name->symbol.Name()
+                << "' isn't representable as " << sem->Type()->FriendlyName();
+            return tint::resolver::Resolve(builder);
+        }
+        const auto* literal = CreateLiteral(builder, sem->Type(), iter->second);
+        if (!literal) {
+            continue;
+        }
+        ctx.Replace(
+            override,
+            builder.Const(ctx.Clone(override->source), ctx.Clone(override->name->symbol), literal)
+        );
+        substituted = true;
+    }
+    if (!substituted) {
+        return SkipTransform;
+    }
+
+    ctx.Clone();
+    return tint::resolver::Resolve(builder);
+}
+
+}  // namespace wgslx::minifier
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "src/tint/lang/wgsl/ast/transform/transform.h"
+
+namespace wgslx::minifier {
+
+// Replaces overrides whose value is known with consts, so the code depending on them can be folded and stripped.
+class SubstituteOverrides final : public tint::Castable<SubstituteOverrides, tint::ast::transform::Transform> {
+ public:
+    using Values = std::unordered_map<std::string, double>;
+
+    struct Config final : public Castable<Config, tint::ast::transform::Data> {
+        explicit Config(Values&& v) : values(std::move(v)) {}
+        // Keyed by the override name, or by the @id of overrides which have one
+        Values values;
+    };
+
+    ApplyResult Apply(
+        const tint::Program& program,
+        const tint::ast::transform::DataMap& inputs,
+        tint::ast::transform::DataMap& outputs
+    ) const override;
+};
+
+}  // namespace wgslx::minifier
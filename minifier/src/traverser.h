@@ -1,20 +1,318 @@
 #pragma once
 
-#include <src/tint/lang/wgsl/ast/attribute.h>
-#include <src/tint/lang/wgsl/ast/case_selector.h>
-#include <src/tint/lang/wgsl/ast/expression.h>
+#include <src/tint/lang/wgsl/ast/accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/alias.h>
+#include <src/tint/lang/wgsl/ast/assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/binary_expression.h>
+#include <src/tint/lang/wgsl/ast/binding_attribute.h>
+#include <src/tint/lang/wgsl/ast/blend_src_attribute.h>
+#include <src/tint/lang/wgsl/ast/block_statement.h>
+#include <src/tint/lang/wgsl/ast/bool_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/break_if_statement.h>
+#include <src/tint/lang/wgsl/ast/break_statement.h>
+#include <src/tint/lang/wgsl/ast/builtin_attribute.h>
+#include <src/tint/lang/wgsl/ast/call_expression.h>
+#include <src/tint/lang/wgsl/ast/call_statement.h>
+#include <src/tint/lang/wgsl/ast/case_statement.h>
+#include <src/tint/lang/wgsl/ast/color_attribute.h>
+#include <src/tint/lang/wgsl/ast/compound_assignment_statement.h>
+#include <src/tint/lang/wgsl/ast/const.h>
+#include <src/tint/lang/wgsl/ast/const_assert.h>
+#include <src/tint/lang/wgsl/ast/continue_statement.h>
+#include <src/tint/lang/wgsl/ast/diagnostic_attribute.h>
+#include <src/tint/lang/wgsl/ast/diagnostic_directive.h>
+#include <src/tint/lang/wgsl/ast/diagnostic_rule_name.h>
+#include <src/tint/lang/wgsl/ast/discard_statement.h>
+#include <src/tint/lang/wgsl/ast/enable.h>
+#include <src/tint/lang/wgsl/ast/float_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/for_loop_statement.h>
+#include <src/tint/lang/wgsl/ast/function.h>
+#include <src/tint/lang/wgsl/ast/group_attribute.h>
+#include <src/tint/lang/wgsl/ast/id_attribute.h>
 #include <src/tint/lang/wgsl/ast/identifier.h>
-#include <src/tint/lang/wgsl/ast/statement.h>
-#include <src/tint/lang/wgsl/ast/variable.h>
-#include <src/tint/utils/symbol/symbol.h>
+#include <src/tint/lang/wgsl/ast/identifier_expression.h>
+#include <src/tint/lang/wgsl/ast/if_statement.h>
+#include <src/tint/lang/wgsl/ast/increment_decrement_statement.h>
+#include <src/tint/lang/wgsl/ast/index_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/input_attachment_index_attribute.h>
+#include <src/tint/lang/wgsl/ast/int_literal_expression.h>
+#include <src/tint/lang/wgsl/ast/internal_attribute.h>
+#include <src/tint/lang/wgsl/ast/interpolate_attribute.h>
+#include <src/tint/lang/wgsl/ast/invariant_attribute.h>
+#include <src/tint/lang/wgsl/ast/let.h>
+#include <src/tint/lang/wgsl/ast/literal_expression.h>
+#include <src/tint/lang/wgsl/ast/location_attribute.h>
+#include <src/tint/lang/wgsl/ast/loop_statement.h>
+#include <src/tint/lang/wgsl/ast/member_accessor_expression.h>
+#include <src/tint/lang/wgsl/ast/must_use_attribute.h>
+#include <src/tint/lang/wgsl/ast/node.h>
+#include <src/tint/lang/wgsl/ast/override.h>
+#include <src/tint/lang/wgsl/ast/parameter.h>
+#include <src/tint/lang/wgsl/ast/phony_expression.h>
+#include <src/tint/lang/wgsl/ast/requires.h>
+#include <src/tint/lang/wgsl/ast/return_statement.h>
+#include <src/tint/lang/wgsl/ast/stage_attribute.h>
+#include <src/tint/lang/wgsl/ast/stride_attribute.h>
+#include <src/tint/lang/wgsl/ast/struct.h>
+#include <src/tint/lang/wgsl/ast/struct_member.h>
+#include <src/tint/lang/wgsl/ast/struct_member_align_attribute.h>
+#include <src/tint/lang/wgsl/ast/struct_member_offset_attribute.h>
+#include <src/tint/lang/wgsl/ast/struct_member_size_attribute.h>
+#include <src/tint/lang/wgsl/ast/switch_statement.h>
+#include <src/tint/lang/wgsl/ast/templated_identifier.h>
+#include <src/tint/lang/wgsl/ast/unary_op_expression.h>
+#include <src/tint/lang/wgsl/ast/var.h>
+#include <src/tint/lang/wgsl/ast/variable_decl_statement.h>
+#include <src/tint/lang/wgsl/ast/while_statement.h>
+#include <src/tint/lang/wgsl/ast/workgroup_attribute.h>
+#include <src/tint/utils/containers/vector.h>
+#include <src/tint/utils/rtti/switch.h>
 
-#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace wgslx::minifier {
 
-void Traverse(const tint::ast::Statement* stmt, const std::function<void(const tint::ast::Identifier*)>& block);
-void Traverse(const tint::ast::Expression* expr, const std::function<void(const tint::ast::Identifier*)>& block);
-void Traverse(const tint::ast::Attribute* attr, const std::function<void(const tint::ast::Identifier*)>& block);
-void Traverse(const tint::ast::Variable* var, const std::function<void(const tint::ast::Identifier*)>& block);
+enum class TraverseAction : std::uint8_t {
+    // Visit the children of the node
+    Continue,
+    // Skip the children of the node
+    Skip,
+    // Stop the whole traversal
+    Stop,
+};
+
+// Walks the AST in source order. The visitor may implement any of
+//   Enter(const tint::ast::Node*) - called before the children of a node
+//   Leave(const tint::ast::Node*) - called after the children of a node, unless they were skipped
+// returning either void or a TraverseAction. The hooks are resolved at compile time.
+// Pending nodes are kept on a heap allocated stack, so deeply nested input can't overflow the native stack.
+template<typename Visitor>
+class Traverser {
+ public:
+    explicit Traverser(Visitor& visitor) : visitor_(visitor) {}
+
+    // Returns false if the traversal has been stopped
+    bool Traverse(const tint::ast::Node* root) {
+        stack_.clear();
+        Push(root);
+        while (!stack_.empty()) {
+            auto entry = stack_.back();
+            stack_.pop_back();
+
+            if (entry.leave) {
+                if (Leave(entry.node) == TraverseAction::Stop) {
+                    return false;
+                }
+                continue;
+            }
+
+            switch (Enter(entry.node)) {
+            case TraverseAction::Continue:
+                break;
+            case TraverseAction::Skip:
+                continue;
+            case TraverseAction::Stop:
+                return false;
+            }
+
+            if constexpr (HasLeave) {
+                stack_.push_back({.node = entry.node, .leave = true});
+            }
+            // Children are pushed in source order, reverse them to pop them in source order
+            auto first = stack_.size();
+            PushChildren(entry.node);
+            std::reverse(stack_.begin() + static_cast<std::ptrdiff_t>(first), stack_.end());
+        }
+        return true;
+    }
+
+ private:
+    struct Entry {
+        const tint::ast::Node* node;
+        bool leave;
+    };
+
+    static constexpr bool HasLeave = requires(Visitor& v, const tint::ast::Node* n) { v.Leave(n); };
+
+    Visitor& visitor_;
+    std::vector<Entry> stack_;
+
+    void Push(const tint::ast::Node* node) {
+        if (node) {
+            stack_.push_back({.node = node, .leave = false});
+        }
+    }
+
+    template<typename T, std::size_t N>
+    void Push(const tint::Vector<T, N>& nodes) {
+        for (const auto* n : nodes) {
+            Push(n);
+        }
+    }
+
+    template<typename... Ts>
+    void PushAll(const Ts&... nodes) {
+        (Push(nodes), ...);
+    }
+
+    TraverseAction Enter(const tint::ast::Node* node) {
+        if constexpr (requires { visitor_.Enter(node); }) {
+            if constexpr (std::is_void_v<decltype(visitor_.Enter(node))>) {
+                visitor_.Enter(node);
+                return TraverseAction::Continue;
+            } else {
+                return visitor_.Enter(node);
+            }
+        } else {
+            return TraverseAction::Continue;
+        }
+    }
+
+    TraverseAction Leave(const tint::ast::Node* node) {
+        if constexpr (HasLeave) {
+            if constexpr (std::is_void_v<decltype(visitor_.Leave(node))>) {
+                visitor_.Leave(node);
+                return TraverseAction::Continue;
+            } else {
+                return visitor_.Leave(node);
+            }
+        } else {
+            return TraverseAction::Continue;
+        }
+    }
+
+    void PushChildren(const tint::ast::Node* node) {
+        Switch(
+            node,
+            // Statements
+            [&](const tint::ast::AssignmentStatement* a) { PushAll(a->lhs, a->rhs); },
+            [&](const tint::ast::BlockStatement* b) { PushAll(b->statements, b->attributes); },
+            [&](const tint::ast::BreakIfStatement* b) { Push(b->condition); },
+            [&](const tint::ast::BreakStatement*) {},
+            [&](const tint::ast::CallStatement* c) { Push(c->expr); },
+            [&](const tint::ast::CaseStatement* c) {
+                for (const auto* s : c->selectors) {
+                    Push(s->expr);
+                }
+                Push(c->body);
+            },
+            [&](const tint::ast::CompoundAssignmentStatement* a) { PushAll(a->lhs, a->rhs); },
+            [&](const tint::ast::ConstAssert* a) { Push(a->condition); },
+            [&](const tint::ast::ContinueStatement*) {},
+            [&](const tint::ast::DiscardStatement*) {},
+            [&](const tint::ast::ForLoopStatement* l) {
+                PushAll(l->initializer, l->condition, l->continuing, l->body, l->attributes);
+            },
+            [&](const tint::ast::IfStatement* i) { PushAll(i->condition, i->body, i->else_statement, i->attributes); },
+            [&](const tint::ast::IncrementDecrementStatement* i) { Push(i->lhs); },
+            [&](const tint::ast::LoopStatement* l) { PushAll(l->body, l->continuing, l->attributes); },
+            [&](const tint::ast::ReturnStatement* r) { Push(r->value); },
+            [&](const tint::ast::SwitchStatement* s) {
+                PushAll(s->condition, s->body, s->attributes, s->body_attributes);
+            },
+            [&](const tint::ast::VariableDeclStatement* v) { Push(v->variable); },
+            [&](const tint::ast::WhileStatement* w) { PushAll(w->condition, w->body, w->attributes); },
+            // Expressions
+            [&](const tint::ast::BinaryExpression* b) { PushAll(b->lhs, b->rhs); },
+            [&](const tint::ast::CallExpression* c) { PushAll(c->target, c->args); },
+            [&](const tint::ast::IdentifierExpression* i) { Push(i->identifier); },
+            [&](const tint::ast::PhonyExpression*) {},
+            [&](const tint::ast::UnaryOpExpression* o) { Push(o->expr); },
+            [&](const tint::ast::IndexAccessorExpression* a) { PushAll(a->object, a->index); },
+            [&](const tint::ast::MemberAccessorExpression* a) { PushAll(a->object, a->member); },
+            [&](const tint::ast::LiteralExpression*) {},
+            // Identifiers
+            [&](const tint::ast::TemplatedIdentifier* t) { PushAll(t->arguments, t->attributes); },
+            [&](const tint::ast::Identifier*) {},
+            // Attributes
+            [&](const tint::ast::BindingAttribute* b) { Push(b->expr); },
+            [&](const tint::ast::BlendSrcAttribute* b) { Push(b->expr); },
+            [&](const tint::ast::BuiltinAttribute*) {},
+            [&](const tint::ast::ColorAttribute* c) { Push(c->expr); },
+            [&](const tint::ast::DiagnosticAttribute* d) {
+                PushAll(d->control.rule_name->category, d->control.rule_name->name);
+            },
+            [&](const tint::ast::GroupAttribute* g) { Push(g->expr); },
+            [&](const tint::ast::IdAttribute* i) { Push(i->expr); },
+            [&](const tint::ast::InputAttachmentIndexAttribute* i) { Push(i->expr); },
+            [&](const tint::ast::InternalAttribute*) {
+                // Skip
+            },
+            [&](const tint::ast::InterpolateAttribute*) {},
+            [&](const tint::ast::InvariantAttribute*) {},
+            [&](const tint::ast::LocationAttribute* l) { Push(l->expr); },
+            [&](const tint::ast::MustUseAttribute*) {},
+            [&](const tint::ast::StageAttribute*) {},
+            [&](const tint::ast::StrideAttribute*) {},
+            [&](const tint::ast::StructMemberAlignAttribute* a) { Push(a->expr); },
+            [&](const tint::ast::StructMemberOffsetAttribute* o) { Push(o->expr); },
+            [&](const tint::ast::StructMemberSizeAttribute* s) { Push(s->expr); },
+            [&](const tint::ast::WorkgroupAttribute* w) { PushAll(w->x, w->y, w->z); },
+            // Variables
+            [&](const tint::ast::Var* v) {
+                PushAll(
+                    v->type.expr,
+                    v->name,
+                    v->initializer,
+                    v->attributes,
+                    v->declared_address_space,
+                    v->declared_access
+                );
+            },
+            [&](const tint::ast::Variable* v) { PushAll(v->type.expr, v->name, v->initializer, v->attributes); },
+            // Declarations
+            [&](const tint::ast::Function* f) {
+                PushAll(f->attributes, f->name, f->params, f->return_type_attributes, f->return_type.expr, f->body);
+            },
+            [&](const tint::ast::Struct* s) { PushAll(s->attributes, s->name, s->members); },
+            [&](const tint::ast::StructMember* m) { PushAll(m->attributes, m->name, m->type.expr); },
+            [&](const tint::ast::Alias* a) { PushAll(a->name, a->type.expr); },
+            [&](const tint::ast::DiagnosticDirective*) {},
+            [&](const tint::ast::Enable*) {},
+            [&](const tint::ast::Requires*) {},
+            TINT_ICE_ON_NO_MATCH
+        );
+    }
+};
+
+// Returns false if the visitor stopped the traversal.
+template<typename Visitor>
+bool Traverse(const tint::ast::Node* node, Visitor&& visitor) {
+    return Traverser<std::remove_reference_t<Visitor>>(visitor).Traverse(node);
+}
+
+template<typename T, typename F>
+struct NodeVisitor {
+    F& block;
+
+    TraverseAction Enter(const tint::ast::Node* node) {
+        if (const auto* t = node->As<T>()) {
+            if constexpr (std::is_void_v<decltype(block(t))>) {
+                block(t);
+            } else {
+                return block(t);
+            }
+        }
+        return TraverseAction::Continue;
+    }
+};
+
+// Calls `block` for every node of type T under `node`, including `node`. `block` may return a TraverseAction.
+template<typename T, typename F>
+bool TraverseNodes(const tint::ast::Node* node, F&& block) {
+    NodeVisitor<T, std::remove_reference_t<F>> visitor {block};
+    return Traverse(node, visitor);
+}
+
+// Calls `block` for every identifier under `node`. `block` may return a TraverseAction.
+template<typename F>
+bool TraverseIdentifiers(const tint::ast::Node* node, F&& block) {
+    return TraverseNodes<tint::ast::Identifier>(node, std::forward<F>(block));
+}
 
 }  // namespace wgslx::minifier
@@ -10,10 +10,14 @@ struct Options {
     bool precise_float = false;
     bool use_type_alias = true;
     bool ignore_literal_suffix = true;
+    // Emits a v3 source map which maps the output back to the sources the AST nodes carry.
+    // The source files must outlive Write().
+    bool source_map = false;
 };
 
 struct Result {
     std::string wgsl;
+    std::string source_map;
     std::string failure_message;
     bool failed = false;
 };
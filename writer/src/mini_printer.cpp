@@ -65,10 +65,14 @@
 
 #include <algorithm>
 #include <format>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/for_each.hpp>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -161,7 +165,10 @@ void MiniPrinter::EmitTypeDecl(std::stringstream& out, const tint::ast::TypeDecl
     Switch(
         td,
         [&](const tint::ast::Alias* alias) {
-            out << "alias " << alias->name->symbol.Name() << "=";
+            AddMapping(out, alias->source);
+            out << "alias ";
+            AddMapping(out, alias->name);
+            out << alias->name->symbol.Name() << "=";
             EmitExpression(out, alias->type, OperatorPosition::Left, OperatorGroup::None);
             out << ";";
         },
@@ -171,9 +178,12 @@ void MiniPrinter::EmitTypeDecl(std::stringstream& out, const tint::ast::TypeDecl
 }
 
 void MiniPrinter::EmitFunction(std::stringstream& out, const tint::ast::Function* func) {
+    AddMapping(out, func->source);
     EmitAttributes(out, func->attributes);
 
-    out << "fn " << func->name->symbol.Name() << "(";
+    out << "fn ";
+    AddMapping(out, func->name);
+    out << func->name->symbol.Name() << "(";
     bool first = true;
     for (auto* v : func->params) {
         if (!first) {
@@ -182,6 +192,7 @@ void MiniPrinter::EmitFunction(std::stringstream& out, const tint::ast::Function
         first = false;
 
         EmitAttributes(out, v->attributes);
+        AddMapping(out, v->name);
         out << v->name->symbol.Name() << ":";
         EmitExpression(out, v->type, OperatorPosition::Left, OperatorGroup::None);
     }
@@ -199,6 +210,7 @@ void MiniPrinter::EmitFunction(std::stringstream& out, const tint::ast::Function
 }
 
 void MiniPrinter::EmitStatement(std::stringstream& out, const tint::ast::Statement* stmt) {
+    AddMapping(out, stmt->source);
     Switch(
         stmt,
         [&](const tint::ast::AssignmentStatement* a) { EmitAssign(out, a); },
@@ -206,7 +218,7 @@ void MiniPrinter::EmitStatement(std::stringstream& out, const tint::ast::Stateme
         [&](const tint::ast::BreakStatement*) { out << "break;"; },
         [&](const tint::ast::BreakIfStatement* b) { EmitBreakIf(out, b); },
         [&](const tint::ast::CallStatement* c) {
-            EmitCall(out, c->expr);
+            EmitExpression(out, c->expr, OperatorPosition::Left, OperatorGroup::None);
             out << ";";
         },
         [&](const tint::ast::CompoundAssignmentStatement* c) { EmitCompoundAssign(out, c); },
@@ -375,6 +387,7 @@ void MiniPrinter::EmitCase(std::stringstream& out, const tint::ast::CaseStatemen
 }
 
 void MiniPrinter::EmitVariable(std::stringstream& out, const tint::ast::Variable* var) {
+    AddMapping(out, var->source);
     EmitAttributes(out, var->attributes);
 
     Switch(
@@ -399,6 +412,7 @@ void MiniPrinter::EmitVariable(std::stringstream& out, const tint::ast::Variable
         TINT_ICE_ON_NO_MATCH
     );
 
+    AddMapping(out, var->name);
     out << var->name->symbol.Name();
     if (auto ty = var->type) {
         out << ":";
@@ -418,8 +432,11 @@ void MiniPrinter::EmitConstAssert(std::stringstream& out, const tint::ast::Const
 }
 
 void MiniPrinter::EmitStructType(std::stringstream& out, const tint::ast::Struct* str) {
+    AddMapping(out, str->source);
     EmitAttributes(out, str->attributes);
-    out << "struct " << str->name->symbol.Name() << "{";
+    out << "struct ";
+    AddMapping(out, str->name);
+    out << str->name->symbol.Name() << "{";
 
     tint::Hashset<std::string, 8> member_names;
     for (auto* mem : str->members) {
@@ -469,6 +486,7 @@ void MiniPrinter::EmitStructType(std::stringstream& out, const tint::ast::Struct
         }
         EmitAttributes(out, attributes_sanitized);
 
+        AddMapping(out, mem->name);
         out << mem->name->symbol.Name() << ":";
         EmitExpression(out, mem->type, OperatorPosition::Left, OperatorGroup::None);
         if (mem != str->members.Back()) {
@@ -582,152 +600,151 @@ void MiniPrinter::EmitAttributes(std::stringstream& out, const tint::VectorRef<c
     }
 }
 
+static std::string_view BinaryOpToString(const tint::core::BinaryOp op) {
+    switch (op) {
+    case tint::core::BinaryOp::kAnd:
+        return "&";
+    case tint::core::BinaryOp::kOr:
+        return "|";
+    case tint::core::BinaryOp::kXor:
+        return "^";
+    case tint::core::BinaryOp::kLogicalAnd:
+        return "&&";
+    case tint::core::BinaryOp::kLogicalOr:
+        return "||";
+    case tint::core::BinaryOp::kEqual:
+        return "==";
+    case tint::core::BinaryOp::kNotEqual:
+        return "!=";
+    case tint::core::BinaryOp::kLessThan:
+        return "<";
+    case tint::core::BinaryOp::kGreaterThan:
+        return ">";
+    case tint::core::BinaryOp::kLessThanEqual:
+        return "<=";
+    case tint::core::BinaryOp::kGreaterThanEqual:
+        return ">=";
+    case tint::core::BinaryOp::kShiftLeft:
+        return "<<";
+    case tint::core::BinaryOp::kShiftRight:
+        return ">>";
+    case tint::core::BinaryOp::kAdd:
+        return "+";
+    case tint::core::BinaryOp::kSubtract:
+        return "-";
+    case tint::core::BinaryOp::kMultiply:
+        return "*";
+    case tint::core::BinaryOp::kDivide:
+        return "/";
+    case tint::core::BinaryOp::kModulo:
+        return "%";
+    }
+    TINT_ICE() << "invalid binary op " << op;
+    return "";
+}
+
 void MiniPrinter::EmitExpression(
     std::stringstream& out,
     const tint::ast::Expression* expr,
     OperatorPosition position,
     OperatorGroup parent
 ) {
-    Switch(
-        expr,
-        [&](const tint::ast::IndexAccessorExpression* a) { EmitIndexAccessor(out, a); },
-        [&](const tint::ast::BinaryExpression* b) { EmitBinary(out, b, position, parent); },
-        [&](const tint::ast::CallExpression* c) { EmitCall(out, c); },
-        [&](const tint::ast::IdentifierExpression* i) { EmitIdentifier(out, i); },
-        [&](const tint::ast::LiteralExpression* l) { EmitLiteral(out, l); },
-        [&](const tint::ast::MemberAccessorExpression* m) { EmitMemberAccessor(out, m); },
-        [&](const tint::ast::PhonyExpression*) { out << "_"; },
-        [&](const tint::ast::UnaryOpExpression* u) { EmitUnaryOp(out, u, position, parent); },
-        TINT_ICE_ON_NO_MATCH
-    );
+    auto base = expression_tasks_.size();
+    expression_tasks_.push_back({.expr = expr, .position = position, .parent = parent});
+    while (expression_tasks_.size() > base) {
+        auto task = expression_tasks_.back();
+        expression_tasks_.pop_back();
+
+        if (task.ident) {
+            EmitIdentifier(out, task.ident);
+            continue;
+        }
+        if (!task.expr) {
+            out << task.text;
+            continue;
+        }
+
+        AddMapping(out, task.expr->source);
+        Switch(
+            task.expr,
+            [&](const tint::ast::IndexAccessorExpression* a) { PushIndexAccessor(a); },
+            [&](const tint::ast::BinaryExpression* b) { PushBinary(b, task.position, task.parent); },
+            [&](const tint::ast::CallExpression* c) { PushCall(c); },
+            [&](const tint::ast::IdentifierExpression* i) { EmitIdentifier(out, i->identifier); },
+            [&](const tint::ast::LiteralExpression* l) { EmitLiteral(out, l); },
+            [&](const tint::ast::MemberAccessorExpression* m) { PushMemberAccessor(m); },
+            [&](const tint::ast::PhonyExpression*) { out << "_"; },
+            [&](const tint::ast::UnaryOpExpression* u) { PushUnaryOp(u, task.position, task.parent); },
+            TINT_ICE_ON_NO_MATCH
+        );
+    }
+}
+
+void MiniPrinter::PushTasks(std::initializer_list<ExpressionTask> tasks) {
+    // The last pushed task is emitted first
+    expression_tasks_.insert(expression_tasks_.end(), std::rbegin(tasks), std::rend(tasks));
 }
 
-void MiniPrinter::EmitIndexAccessor(std::stringstream& out, const tint::ast::IndexAccessorExpression* expr) {
+void MiniPrinter::PushIndexAccessor(const tint::ast::IndexAccessorExpression* expr) {
     bool paren_lhs =
         !expr->object
              ->IsAnyOf<tint::ast::AccessorExpression, tint::ast::CallExpression, tint::ast::IdentifierExpression>();
-    if (paren_lhs) {
-        out << "(";
-    }
-    EmitExpression(out, expr->object, OperatorPosition::Left, OperatorGroup::None);
-    if (paren_lhs) {
-        out << ")";
-    }
-    out << "[";
-    EmitExpression(out, expr->index, OperatorPosition::Left, OperatorGroup::None);
-    out << "]";
+    PushTasks({
+        {.text = paren_lhs ? "(" : ""},
+        {.expr = expr->object},
+        {.text = paren_lhs ? ")" : ""},
+        {.text = "["},
+        {.expr = expr->index},
+        {.text = "]"},
+    });
 }
 
-void MiniPrinter::EmitMemberAccessor(std::stringstream& out, const tint::ast::MemberAccessorExpression* expr) {
+void MiniPrinter::PushMemberAccessor(const tint::ast::MemberAccessorExpression* expr) {
     bool paren_lhs =
         !expr->object
              ->IsAnyOf<tint::ast::AccessorExpression, tint::ast::CallExpression, tint::ast::IdentifierExpression>();
-    if (paren_lhs) {
-        out << "(";
-    }
-    EmitExpression(out, expr->object, OperatorPosition::Left, OperatorGroup::None);
-    if (paren_lhs) {
-        out << ")";
-    }
-    out << "." << expr->member->symbol.Name();
+    PushTasks({
+        {.text = paren_lhs ? "(" : ""},
+        {.expr = expr->object},
+        {.text = paren_lhs ? ")" : ""},
+        {.text = "."},
+        {.ident = expr->member},
+    });
 }
 
-void MiniPrinter::EmitBinary(
-    std::stringstream& out,
+void MiniPrinter::PushBinary(
     const tint::ast::BinaryExpression* expr,
     OperatorPosition position,
     OperatorGroup parent
 ) {
     auto group = toOperatorGroup(expr->op);
     auto paren = isParenthesisRequired(group, position, parent);
-    if (paren) {
-        out << "(";
-    }
-    EmitExpression(out, expr->lhs, OperatorPosition::Left, group);
-    EmitBinaryOp(out, expr->op);
-    EmitExpression(out, expr->rhs, OperatorPosition::Right, group);
-    if (paren) {
-        out << ")";
-    }
+    PushTasks({
+        {.text = paren ? "(" : ""},
+        {.expr = expr->lhs, .position = OperatorPosition::Left, .parent = group},
+        {.text = BinaryOpToString(expr->op)},
+        {.expr = expr->rhs, .position = OperatorPosition::Right, .parent = group},
+        {.text = paren ? ")" : ""},
+    });
 }
 
 void MiniPrinter::EmitBinaryOp(std::stringstream& out, const tint::core::BinaryOp op) {
-    switch (op) {
-    case tint::core::BinaryOp::kAnd:
-        out << "&";
-        return;
-    case tint::core::BinaryOp::kOr:
-        out << "|";
-        return;
-    case tint::core::BinaryOp::kXor:
-        out << "^";
-        return;
-    case tint::core::BinaryOp::kLogicalAnd:
-        out << "&&";
-        return;
-    case tint::core::BinaryOp::kLogicalOr:
-        out << "||";
-        return;
-    case tint::core::BinaryOp::kEqual:
-        out << "==";
-        return;
-    case tint::core::BinaryOp::kNotEqual:
-        out << "!=";
-        return;
-    case tint::core::BinaryOp::kLessThan:
-        out << "<";
-        return;
-    case tint::core::BinaryOp::kGreaterThan:
-        out << ">";
-        return;
-    case tint::core::BinaryOp::kLessThanEqual:
-        out << "<=";
-        return;
-    case tint::core::BinaryOp::kGreaterThanEqual:
-        out << ">=";
-        return;
-    case tint::core::BinaryOp::kShiftLeft:
-        out << "<<";
-        return;
-    case tint::core::BinaryOp::kShiftRight:
-        out << ">>";
-        return;
-    case tint::core::BinaryOp::kAdd:
-        out << "+";
-        return;
-    case tint::core::BinaryOp::kSubtract:
-        out << "-";
-        return;
-    case tint::core::BinaryOp::kMultiply:
-        out << "*";
-        return;
-    case tint::core::BinaryOp::kDivide:
-        out << "/";
-        return;
-    case tint::core::BinaryOp::kModulo:
-        out << "%";
-        return;
-    }
-    TINT_ICE() << "invalid binary op " << op;
+    out << BinaryOpToString(op);
 }
 
-void MiniPrinter::EmitCall(std::stringstream& out, const tint::ast::CallExpression* expr) {
-    EmitExpression(out, expr->target, OperatorPosition::Left, OperatorGroup::Primary);
-    out << "(";
-    bool first = true;
-    const auto& args = expr->args;
-    for (auto* arg : args) {
-        if (!first) {
-            out << ",";
+void MiniPrinter::PushCall(const tint::ast::CallExpression* expr) {
+    // Pushed in reverse order
+    expression_tasks_.push_back({.text = ")"});
+    for (auto i = expr->args.Length(); i > 0; --i) {
+        expression_tasks_.push_back({.expr = expr->args[i - 1]});
+        if (i > 1) {
+            expression_tasks_.push_back({.text = ","});
         }
-        first = false;
-        EmitExpression(out, arg, OperatorPosition::Left, OperatorGroup::None);
     }
-    out << ")";
-}
-
-void MiniPrinter::EmitIdentifier(std::stringstream& out, const tint::ast::IdentifierExpression* expr) {
-    EmitIdentifier(out, expr->identifier);
+    expression_tasks_.push_back({.text = "("});
+    expression_tasks_.push_back(
+        {.expr = expr->target, .position = OperatorPosition::Left, .parent = OperatorGroup::Primary}
+    );
 }
 
 static const std::unordered_map<std::string, std::string> TypeAliases {
@@ -764,10 +781,17 @@ static const std::unordered_map<std::string, std::string> TypeAliases {
 };
 
 void MiniPrinter::EmitIdentifier(std::stringstream& out, const tint::ast::Identifier* ident) {
+    AddMapping(out, ident);
     if (auto* tmpl_ident = ident->As<tint::ast::TemplatedIdentifier>()) {
         EmitAttributes(out, tmpl_ident->attributes);
 
+        // The arguments are mapped as if the list is emitted, and dropped if an alias is emitted instead
         std::stringstream ss;
+        auto checkpoint = source_map_.Save();
+        auto offset = options_->source_map ? Offset(out) : std::nullopt;
+        if (offset) {
+            stream_offsets_.emplace_back(&ss, *offset);
+        }
         ss << ident->symbol.Name() << "<";
         for (auto* expr : tmpl_ident->arguments) {
             if (expr != tmpl_ident->arguments.Front()) {
@@ -776,11 +800,15 @@ void MiniPrinter::EmitIdentifier(std::stringstream& out, const tint::ast::Identi
             EmitExpression(ss, expr, OperatorPosition::Left, OperatorGroup::None);
         }
         ss << ">";
+        if (offset) {
+            stream_offsets_.pop_back();
+        }
 
         std::string name = std::move(ss).str();
         if (options_->use_type_alias) {
             auto iter = TypeAliases.find(name);
             if (iter != TypeAliases.end()) {
+                source_map_.Restore(checkpoint);
                 out << iter->second;
             } else {
                 out << name;
@@ -828,41 +856,74 @@ void MiniPrinter::EmitLiteral(std::stringstream& out, const tint::ast::LiteralEx
     );
 }
 
-void MiniPrinter::EmitUnaryOp(
-    std::stringstream& out,
+void MiniPrinter::PushUnaryOp(
     const tint::ast::UnaryOpExpression* expr,
     OperatorPosition position,
     OperatorGroup parent
 ) {
-    auto paren = isParenthesisRequired(OperatorGroup::Unary, position, parent);
-    if (paren) {
-        out << "(";
-    }
+    std::string_view op;
     switch (expr->op) {
     case tint::core::UnaryOp::kAddressOf:
-        out << "&";
+        op = "&";
         break;
     case tint::core::UnaryOp::kComplement:
-        out << "~";
+        op = "~";
         break;
     case tint::core::UnaryOp::kIndirection:
-        out << "*";
+        op = "*";
         break;
     case tint::core::UnaryOp::kNot:
-        out << "!";
+        op = "!";
         break;
     case tint::core::UnaryOp::kNegation:
-        out << "-";
+        op = "-";
         break;
     }
-    EmitExpression(out, expr->expr, OperatorPosition::Right, OperatorGroup::Unary);
-    if (paren) {
-        out << ")";
-    }
+    auto paren = isParenthesisRequired(OperatorGroup::Unary, position, parent);
+    PushTasks({
+        {.text = paren ? "(" : ""},
+        {.text = op},
+        {.expr = expr->expr, .position = OperatorPosition::Right, .parent = OperatorGroup::Unary},
+        {.text = paren ? ")" : ""},
+    });
 }
 
 std::string MiniPrinter::Result() {
     return std::move(ss_).str();
 }
 
+std::string MiniPrinter::SourceMapResult() const {
+    return source_map_.Generate();
+}
+
+std::optional<std::size_t> MiniPrinter::Offset(std::stringstream& out) {
+    if (&out == &ss_) {
+        return static_cast<std::size_t>(out.tellp());
+    }
+    for (auto [stream, offset] : stream_offsets_) {
+        if (stream == &out) {
+            return offset + static_cast<std::size_t>(out.tellp());
+        }
+    }
+    return std::nullopt;
+}
+
+void MiniPrinter::AddMapping(std::stringstream& out, const tint::Source& source, std::string_view name) {
+    if (!options_->source_map) {
+        return;
+    }
+    if (auto offset = Offset(out)) {
+        source_map_.Add(*offset, source, name);
+    }
+}
+
+void MiniPrinter::AddMapping(std::stringstream& out, const tint::ast::Identifier* ident) {
+    // The source of a templated identifier covers its template list, and only user declarations are renamed
+    if (ident->Is<tint::ast::TemplatedIdentifier>()) {
+        AddMapping(out, ident->source);
+    } else {
+        AddMapping(out, ident->source, ident->symbol.NameView());
+    }
+}
+
 }  // namespace wgslx::writer
@@ -21,10 +21,17 @@
 #include <src/tint/lang/wgsl/program/program.h>
 #include <src/tint/utils/generator/text_generator.h>
 
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "operator_group.h"
+#include "source_map.h"
 #include "writer/writer.h"
 
 namespace wgslx::writer {
@@ -37,10 +44,32 @@ class MiniPrinter {
 
     std::string Result();
 
+    std::string SourceMapResult() const;
+
  private:
     const tint::Program* program_;
     const Options* options_;
     std::stringstream ss_;
+    SourceMap source_map_;
+
+    // A pending step of EmitExpression: an expression, an identifier or plain text
+    struct ExpressionTask {
+        const tint::ast::Expression* expr = nullptr;
+        const tint::ast::Identifier* ident = nullptr;
+        std::string_view text;
+        OperatorPosition position = OperatorPosition::Left;
+        OperatorGroup parent = OperatorGroup::None;
+    };
+    // Expressions are emitted from this stack instead of recursively, so long chains like a+b+c+... can't
+    // overflow the native stack. Nested EmitExpression calls share it.
+    std::vector<ExpressionTask> expression_tasks_;
+    // Streams of template lists being emitted, with the offset in the output where their text would start
+    std::vector<std::pair<const std::stringstream*, std::size_t>> stream_offsets_;
+
+    std::optional<std::size_t> Offset(std::stringstream& out);
+
+    void AddMapping(std::stringstream& out, const tint::Source& source, std::string_view name = {});
+    void AddMapping(std::stringstream& out, const tint::ast::Identifier* ident);
 
     void EmitEnables(std::stringstream& out);
     void EmitRequires(std::stringstream& out);
@@ -71,25 +100,15 @@ class MiniPrinter {
         OperatorPosition position,
         OperatorGroup parent
     );
-    void EmitIndexAccessor(std::stringstream& out, const tint::ast::IndexAccessorExpression* expr);
-    void EmitMemberAccessor(std::stringstream& out, const tint::ast::MemberAccessorExpression* expr);
-    void EmitBinary(
-        std::stringstream& out,
-        const tint::ast::BinaryExpression* expr,
-        OperatorPosition position,
-        OperatorGroup parent
-    );
+    void PushTasks(std::initializer_list<ExpressionTask> tasks);
+    void PushIndexAccessor(const tint::ast::IndexAccessorExpression* expr);
+    void PushMemberAccessor(const tint::ast::MemberAccessorExpression* expr);
+    void PushBinary(const tint::ast::BinaryExpression* expr, OperatorPosition position, OperatorGroup parent);
     void EmitBinaryOp(std::stringstream& out, const tint::core::BinaryOp op);
-    void EmitCall(std::stringstream& out, const tint::ast::CallExpression* expr);
-    void EmitIdentifier(std::stringstream& out, const tint::ast::IdentifierExpression* expr);
+    void PushCall(const tint::ast::CallExpression* expr);
     void EmitIdentifier(std::stringstream& out, const tint::ast::Identifier* ident);
     void EmitLiteral(std::stringstream& out, const tint::ast::LiteralExpression* lit);
-    void EmitUnaryOp(
-        std::stringstream& out,
-        const tint::ast::UnaryOpExpression* expr,
-        OperatorPosition position,
-        OperatorGroup parent
-    );
+    void PushUnaryOp(const tint::ast::UnaryOpExpression* expr, OperatorPosition position, OperatorGroup parent);
 };
 
 }  // namespace wgslx::writer
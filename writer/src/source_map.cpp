@@ -0,0 +1,156 @@
+#include "source_map.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace wgslx::writer {
+
+static constexpr const char* Base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void AppendVLQ(std::string& out, std::int64_t value) {
+    auto vlq = value < 0 ? (static_cast<std::uint64_t>(-value) << 1) | 1 : static_cast<std::uint64_t>(value) << 1;
+    do {
+        auto digit = vlq & 0x1f;
+        vlq >>= 5;
+        if (vlq != 0) {
+            digit |= 0x20;
+        }
+        out += Base64Chars[digit];
+    } while (vlq != 0);
+}
+
+static void AppendString(std::string& out, std::string_view str) {
+    out += '"';
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                static constexpr const char* HexChars = "0123456789abcdef";
+                out += "\\u00";
+                out += HexChars[(c >> 4) & 0xf];
+                out += HexChars[c & 0xf];
+            } else {
+                out += c;
+            }
+            break;
+        }
+    }
+    out += '"';
+}
+
+// The text the source range covered in the original file, as long as it fits on one line.
+static std::string_view OriginalText(const tint::Source& source) {
+    const auto& range = source.range;
+    if (range.begin.line != range.end.line || range.end.column <= range.begin.column) {
+        return {};
+    }
+    const auto& lines = source.file->content.lines;
+    if (range.begin.line > lines.size()) {
+        return {};
+    }
+    auto line = lines[range.begin.line - 1];
+    if (range.end.column - 1 > line.size()) {
+        return {};
+    }
+    return line.substr(range.begin.column - 1, range.end.column - range.begin.column);
+}
+
+void SourceMap::Add(std::size_t offset, const tint::Source& source, std::string_view emitted_name) {
+    if (!source.file || source.range.begin.line == 0 || source.range.begin.column == 0) {
+        return;
+    }
+
+    auto source_index = source_indices_.GetOrAdd(source.file, [&] {
+        sources_.push_back(source.file);
+        return static_cast<std::uint32_t>(sources_.size() - 1);
+    });
+
+    std::int32_t name = -1;
+    if (!emitted_name.empty()) {
+        auto original = OriginalText(source);
+        if (!original.empty() && original != emitted_name) {
+            name = name_indices_.GetOrAdd(original, [&] {
+                names_.push_back(original);
+                return static_cast<std::int32_t>(names_.size() - 1);
+            });
+        }
+    }
+
+    Mapping mapping {
+        .generated_column = static_cast<std::uint32_t>(offset),
+        .source = source_index,
+        .line = source.range.begin.line - 1,
+        .column = source.range.begin.column - 1,
+        .name = name,
+    };
+    if (!mappings_.empty() && mappings_.back().generated_column == mapping.generated_column) {
+        // Nested nodes starting at the same offset, keep the innermost one
+        mappings_.back() = mapping;
+    } else {
+        mappings_.push_back(mapping);
+    }
+}
+
+SourceMap::Checkpoint SourceMap::Save() const {
+    return {.mappings = mappings_.size(), .sources = sources_.size(), .names = names_.size()};
+}
+
+void SourceMap::Restore(const Checkpoint& checkpoint) {
+    mappings_.resize(checkpoint.mappings);
+    for (auto i = checkpoint.sources; i < sources_.size(); ++i) {
+        source_indices_.Remove(sources_[i]);
+    }
+    sources_.resize(checkpoint.sources);
+    for (auto i = checkpoint.names; i < names_.size(); ++i) {
+        name_indices_.Remove(names_[i]);
+    }
+    names_.resize(checkpoint.names);
+}
+
+std::string SourceMap::Generate() const {
+    std::string out = R"({"version":3,"sources":[)";
+    for (const auto* file : sources_) {
+        if (file != sources_.front()) {
+            out += ",";
+        }
+        AppendString(out, file->path);
+    }
+    out += R"(],"names":[)";
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+        if (i != 0) {
+            out += ",";
+        }
+        AppendString(out, names_[i]);
+    }
+    out += R"(],"mappings":")";
+
+    // All fields are relative to the previous segment
+    Mapping previous {};
+    std::int32_t previous_name = 0;
+    for (std::size_t i = 0; i < mappings_.size(); ++i) {
+        const auto& mapping = mappings_[i];
+        if (i != 0) {
+            out += ",";
+        }
+        AppendVLQ(out, std::int64_t {mapping.generated_column} - previous.generated_column);
+        AppendVLQ(out, std::int64_t {mapping.source} - previous.source);
+        AppendVLQ(out, std::int64_t {mapping.line} - previous.line);
+        AppendVLQ(out, std::int64_t {mapping.column} - previous.column);
+        if (mapping.name >= 0) {
+            AppendVLQ(out, std::int64_t {mapping.name} - previous_name);
+            previous_name = mapping.name;
+        }
+        previous = mapping;
+    }
+    out += "\"}";
+    return out;
+}
+
+}  // namespace wgslx::writer
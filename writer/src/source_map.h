@@ -0,0 +1,47 @@
+#pragma once
+
+// https://tc39.es/source-map/
+
+#include <src/tint/utils/containers/hashmap.h>
+#include <src/tint/utils/diagnostic/source.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wgslx::writer {
+
+class SourceMap {
+ public:
+    // The minified output is a single line, so a generated position is just an offset.
+    void Add(std::size_t offset, const tint::Source& source, std::string_view emitted_name = {});
+
+    std::string Generate() const;
+
+    // The mappings added so far, to drop those of text which ends up not being emitted
+    struct Checkpoint {
+        std::size_t mappings;
+        std::size_t sources;
+        std::size_t names;
+    };
+    Checkpoint Save() const;
+    void Restore(const Checkpoint& checkpoint);
+
+ private:
+    struct Mapping {
+        std::uint32_t generated_column;
+        std::uint32_t source;
+        std::uint32_t line;
+        std::uint32_t column;
+        std::int32_t name;
+    };
+
+    std::vector<Mapping> mappings_;
+    std::vector<const tint::Source::File*> sources_;
+    std::vector<std::string_view> names_;
+    tint::Hashmap<const tint::Source::File*, std::uint32_t, 4> source_indices_;
+    tint::Hashmap<std::string_view, std::int32_t, 32> name_indices_;
+};
+
+}  // namespace wgslx::writer
@@ -11,6 +11,7 @@ Result Write(const tint::Program& program, const Options& options) {
     printer.Generate();
     return {
         .wgsl = printer.Result(),
+        .source_map = options.source_map ? printer.SourceMapResult() : std::string(),
     };
 }
 
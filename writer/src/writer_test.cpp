@@ -2,8 +2,11 @@
 
 #include <gmock/gmock.h>
 #include <src/tint/lang/wgsl/common/allowed_features.h>
+#include <src/tint/lang/wgsl/program/clone_context.h>
 #include <src/tint/lang/wgsl/program/program.h>
+#include <src/tint/lang/wgsl/program/program_builder.h>
 #include <src/tint/lang/wgsl/reader/reader.h>
+#include <src/tint/lang/wgsl/resolver/resolve.h>
 #include <src/tint/lang/wgsl/writer/writer.h>
 #include <src/tint/utils/diagnostic/diagnostic.h>
 
@@ -232,6 +235,58 @@ TEST(writer, remove_space_after_var_uniform) {
     EXPECT_EQ(result.wgsl, "@group(0)@binding(0)var<uniform>a:i32;");
 }
 
+TEST(writer, source_map) {
+    tint::Source::File file("a.wgsl", "fn average(a: array<f32, 2>) -> f32 {\n  return a[0] + a[1];\n}\n");
+    auto parsed = tint::wgsl::reader::Parse(&file, {});
+    ASSERT_TRUE(parsed.IsValid()) << parsed.Diagnostics().Str();
+
+    // Rename as the minifier does, the names keep their sources
+    tint::ProgramBuilder builder;
+    tint::program::CloneContext ctx(&builder, &parsed, false);
+    ctx.ReplaceAll([&](tint::Symbol symbol) {
+        auto name = symbol.Name();
+        return builder.Symbols().Register(name == "average" ? "f" : name == "a" ? "x" : name);
+    });
+    ctx.Clone();
+    auto program = tint::resolver::Resolve(builder);
+    ASSERT_TRUE(program.IsValid()) << program.Diagnostics().Str();
+
+    auto result = Write(program, {.source_map = true});
+    EXPECT_EQ(result.wgsl, "fn f(x:array<f32,2>)->f32{return x[0]+x[1];}");
+    // fn, f, x, array, f32 and 2 of the template list, f32, {, return, x, 0, x, 1
+    EXPECT_EQ(
+        result.source_map,
+        R"({"version":3,"sources":["a.wgsl"],"names":["average","a"],)"
+        R"("mappings":"AAAA,GAAGA,EAAQC,EAAG,MAAM,IAAK,KAAO,GAAI,CAClC,OAAOA,EAAE,GAAKA,EAAE"})"
+    );
+
+    auto without = Write(program, {});
+    EXPECT_EQ(without.wgsl, result.wgsl);
+    EXPECT_TRUE(without.source_map.empty());
+
+    // Aliased types are emitted without their template list, so its arguments have no mappings
+    tint::Source::File aliased("b.wgsl", "fn g() -> vec2<f32> {\n  return vec2<f32>();\n}\n");
+    auto aliased_program = tint::wgsl::reader::Parse(&aliased, {});
+    auto aliased_result = Write(aliased_program, {.source_map = true});
+    EXPECT_EQ(aliased_result.wgsl, "fn g()->vec2f{return vec2f();}");
+    EXPECT_EQ(
+        aliased_result.source_map,
+        R"({"version":3,"sources":["b.wgsl"],"names":[],"mappings":"AAAA,GAAG,KAAO,KAAU,CAClB,OAAO"})"
+    );
+}
+
+TEST(writer, deep_expression) {
+    // Machine generated chains must not overflow the native stack
+    std::string code = "const a=0u";
+    for (auto i = 1; i < 10000; ++i) {
+        code += "+" + std::to_string(i % 7) + "u";
+    }
+    code += ";";
+    auto program = Parse(code.c_str());
+    auto result = Write(program, {.ignore_literal_suffix = false});
+    EXPECT_EQ(result.wgsl, code);
+}
+
 TEST(writer, dawn_files) {
     auto dir = std::filesystem::path(__FILE__).parent_path().parent_path().parent_path() / "third_party" / "dawn" /
                "test" / "tint";